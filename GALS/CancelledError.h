@@ -0,0 +1,17 @@
+#ifndef CANCELLED_ERROR_H
+#define CANCELLED_ERROR_H
+
+#include "AnalysisError.h"
+
+#include <string>
+
+// lançado quando a compilação é cancelada no meio (ver Sintatico::setCancelamento)
+class CancelledError : public AnalysisError
+{
+public:
+
+    CancelledError(const std::string &msg = "Compilação cancelada", int position = -1)
+      : AnalysisError(msg, position) { }
+};
+
+#endif
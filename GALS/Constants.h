@@ -102,9 +102,14 @@ enum TokenId
 
 const int STATES_COUNT = 266;
 
-extern int SCANNER_TABLE[STATES_COUNT][256];
+// DFA compactado: byte -> classe de equivalência, estado x classe -> estado
+const int SCANNER_CLASSES = 64; // 59 classes, linhas alinhadas em 64
 
-extern int TOKEN_STATE[STATES_COUNT];
+extern const unsigned char SCANNER_CLASS[256];
+
+extern const short SCANNER_TABLE[STATES_COUNT][SCANNER_CLASSES];
+
+extern const int TOKEN_STATE[STATES_COUNT];
 
 extern const char *SCANNER_ERROR[STATES_COUNT];
 
@@ -117,10 +122,35 @@ const int ACCEPT = 3;
 const int GO_TO  = 4;
 const int ERROR  = 5;
 
-extern const int PARSER_TABLE[359][175][2];
+// Tabela LR compactada por deslocamento de linhas (comb vector).
+// Cada ação é uma palavra de 16 bits: tipo nos 4 bits altos, valor nos 12 baixos.
+//   ação(estado, token): i = PARSER_ACTION_BASE[estado] + token-1;
+//                        CHECK[i] == estado ? NEXT[i] : PARSER_ACTION_DEFAULT[estado]
+//   desvio(estado, símbolo): i = PARSER_GOTO_BASE[símbolo-FIRST_NON_TERMINAL] + estado;
+//                        CHECK[i] == coluna ? NEXT[i] : PARSER_GOTO_DEFAULT[coluna]
+// O padrão de uma linha é ERROR ou a redução mais frequente; quando é uma
+// redução, os erros da linha ficam explícitos, então a detecção de erros não muda.
+const int PARSER_STATES       = 359;
+const int FIRST_NON_TERMINAL  = 95;
+const int PARSER_GOTO_SYMBOLS = 81;   // não-terminais + ações semânticas
+const int PARSER_ACTION_SIZE  = 6912;
+const int PARSER_GOTO_SIZE    = 372;
+
+inline int actionKind(unsigned short word)  { return word >> 12; }
+inline int actionValue(unsigned short word) { return word & 0x0FFF; }
+
+extern const unsigned short PARSER_ACTION_DEFAULT[PARSER_STATES];
+extern const short          PARSER_ACTION_BASE[PARSER_STATES];
+extern const unsigned short PARSER_ACTION_NEXT[PARSER_ACTION_SIZE];
+extern const short          PARSER_ACTION_CHECK[PARSER_ACTION_SIZE];
+
+extern const short       PARSER_GOTO_DEFAULT[PARSER_GOTO_SYMBOLS];
+extern const short       PARSER_GOTO_BASE[PARSER_GOTO_SYMBOLS];
+extern const short       PARSER_GOTO_NEXT[PARSER_GOTO_SIZE];
+extern const signed char PARSER_GOTO_CHECK[PARSER_GOTO_SIZE];
 
-extern const int PRODUCTIONS[159][2];
+extern const unsigned char PRODUCTIONS[159][2];
 
-extern const char *PARSER_ERROR[359];
+extern const char *PARSER_ERROR[PARSER_STATES];
 
 #endif
@@ -3,57 +3,63 @@
 void Lexico::setInput(const char *input)
 {
     this->input = input;
+    nomes.clear();   // nova entrada = nova compilação
     setPosition(0);
 }
 
-Token *Lexico::nextToken()
+bool Lexico::nextToken(Token &token)
 {
-    if ( ! hasInput() )
-        return 0;
-
-    unsigned start = position;
+    for (;;)
+    {
+        if ( ! hasInput() )
+            return false;
 
-    int state = 0;
-    int oldState = 0;
-    int endState = -1;
-    int end = -1;
+        unsigned start = position;
 
-    while (hasInput())
-    {
-        oldState = state;
-        state = nextState(nextChar(), state);
+        int state = 0;
+        int oldState = 0;
+        int endState = -1;
+        int end = -1;
 
-        if (state < 0)
-            break;
+        // laço quente: índices locais e tabelas acessadas direto
+        const unsigned char *text = reinterpret_cast<const unsigned char *>(input.data());
+        const unsigned size = static_cast<unsigned>(input.size());
+        unsigned pos = position;
 
-        else
+        while (pos < size)
         {
-            if (tokenForState(state) >= 0)
+            oldState = state;
+            state = SCANNER_TABLE[state][SCANNER_CLASS[text[pos++]]];
+
+            if (state < 0)
+                break;
+
+            if (TOKEN_STATE[state] >= 0)
             {
                 endState = state;
-                end = position;
+                end = pos;
             }
         }
-    }
-    if (endState < 0 || (endState != state && tokenForState(oldState) == -2))
-        throw LexicalError(SCANNER_ERROR[oldState], start);
+        position = pos;
+        if (endState < 0 || (endState != state && tokenForState(oldState) == -2))
+            throw LexicalError(SCANNER_ERROR[oldState], start);
 
-    position = end;
+        position = end;
 
-    TokenId token = tokenForState(endState);
+        TokenId id = tokenForState(endState);
 
-    if (token == 0)
-        return nextToken();
-    else
-    {
-            std::string lexeme = input.substr(start, end-start);
-            return new Token(token, lexeme, start);
+        if (id == 0)
+            continue;   // token ignorado (espaços)
+
+        std::string_view lexeme = std::string_view(input).substr(start, end-start);
+        token = Token(id, lexeme, start, id == t_ID ? nomes.intern(lexeme) : -1);
+        return true;
     }
 }
 
 int Lexico::nextState(unsigned char c, int state) const
 {
-    int next = SCANNER_TABLE[state][c];
+    int next = SCANNER_TABLE[state][SCANNER_CLASS[c]];
     return next;
 }
 
@@ -3,6 +3,7 @@
 
 #include "Token.h"
 #include "LexicalError.h"
+#include "interner.h"
 
 #include <string>
 
@@ -13,11 +14,18 @@ public:
 
     void setInput(const char *input);
     void setPosition(unsigned pos) { position = pos; }
-    Token *nextToken();
+
+    // preenche 'token' e retorna true; false no fim da entrada
+    bool nextToken(Token &token);
+
+    // identificadores vistos nesta compilação (ids em Token::getSymbol)
+    Interner &interner() { return nomes; }
+    const Interner &interner() const { return nomes; }
 
 private:
     unsigned position;
     std::string input;
+    Interner nomes;
 
     int nextState(unsigned char c, int state) const;
     TokenId tokenForState(int state) const;
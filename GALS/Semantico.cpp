@@ -2,29 +2,29 @@
 #include "Token.h"
 #include "SemanticError.h"
 
-#include "CodeGeneratorBIP.h"
+#include "codegeneratorbip.h"
 
 #include <iostream>
 #include <algorithm>
 #include <string>
 
 // ==== helpers de tipos ====
-static TipoBase stringToTipoBase(const std::string& t) {
-    std::string s = t;
-    std::transform(s.begin(), s.end(), s.begin(), ::tolower);
-
-    if (s == "int")    return TipoBase::T_INT;
-    if (s == "float")  return TipoBase::T_FLOAT;
-    if (s == "char")   return TipoBase::T_CHAR;
-    if (s == "bool")   return TipoBase::T_BOOL;
-    if (s == "string") return TipoBase::T_STRING;
-    if (s == "double") return TipoBase::T_DOUBLE;
-    if (s == "long")   return TipoBase::T_LONG;
-    if (s == "void")   return TipoBase::T_VOID;
-    return TipoBase::T_DESCONHECIDO;
+// tipo da declaração direto do token da palavra-chave
+static TipoBase tipoDoToken(int id) {
+    switch (id) {
+    case t_KEY_INT:    return TipoBase::T_INT;
+    case t_KEY_FLOAT:  return TipoBase::T_FLOAT;
+    case t_KEY_CHAR:   return TipoBase::T_CHAR;
+    case t_KEY_BOOL:   return TipoBase::T_BOOL;
+    case t_KEY_STRING: return TipoBase::T_STRING;
+    case t_KEY_DOUBLE: return TipoBase::T_DOUBLE;
+    case t_KEY_LONG:   return TipoBase::T_LONG;
+    case t_KEY_VOID:   return TipoBase::T_VOID;
+    default:           return TipoBase::T_DESCONHECIDO;
+    }
 }
 
-static std::string tipoBaseToString(TipoBase t) {
+std::string tipoBaseToString(TipoBase t) {
     switch (t) {
     case TipoBase::T_INT:    return "int";
     case TipoBase::T_FLOAT:  return "float";
@@ -81,172 +81,149 @@ static bool tiposCompativeis(TipoBase esperado, TipoBase recebido) {
 }
 
 
-static std::string g_ultimoIdVisto;
-static std::string g_ultimoIdAntesDaAtrib;
-static bool        g_inParamList = false;
-static bool        g_nextBraceIsFuncBody = false;
-static std::string g_funcEmConstrucao;
-static std::vector<Simbolo> g_paramBuffer;
+const char* modalidadeToString(Modalidade m) {
+    switch (m) {
+    case Modalidade::Variavel:  return "variavel";
+    case Modalidade::Parametro: return "parametro";
+    case Modalidade::Funcao:    return "funcao";
+    case Modalidade::Vetor:     return "vetor";
+    }
+    return "";
+}
 
-std::ostream& operator<<(std::ostream& os, const Simbolo& s) {
-    os << "Tipo: " << s.tipo
-       << " - Nome: " << s.nome
-       << " - Modalidade: " << s.modalidade
-       << " - Escopo: " << s.escopo
-       << " - Usado: " << (s.usado ? "Sim" : "Não")
-       << " - Inicializado: " << (s.inicializado ? "Sim" : "Não");
-    return os;
+std::string nomeEscopo(const std::vector<Simbolo>& tabela, const Simbolo& s) {
+    if (s.escopo == ESCOPO_GLOBAL) return "global";
+    return tabela[s.escopo].nome;
 }
 
-// Promove o último ID declarado para FUNÇÃO
-static void promoverParaFuncao(
-    const std::string& nomeFunc,
-    std::vector<std::vector<Simbolo>>& pilhaEscopos,
-    std::vector<Simbolo>& tabelaSimbolo
-    ){
-    if (nomeFunc.empty() || pilhaEscopos.empty()) return;
-    for (auto& s : pilhaEscopos.back()) {
-        if (s.nome == nomeFunc) {
-            s.modalidade = "funcao";
-            s.escopo = "global";
-            s.inicializado = true;
-            for (auto& t : tabelaSimbolo)
-                if (t.nome == s.nome && t.tipo == s.tipo && t.escopo == "global")
-                { t.modalidade = "funcao"; t.inicializado = true; }
-            return;
-        }
-    }
+std::string descreverSimbolo(const std::vector<Simbolo>& tabela, const Simbolo& s) {
+    return "Tipo: " + tipoBaseToString(s.tipo) +
+           " - Nome: " + s.nome +
+           " - Modalidade: " + modalidadeToString(s.modalidade) +
+           " - Escopo: " + nomeEscopo(tabela, s) +
+           " - Usado: " + (s.usado ? "Sim" : "Não") +
+           " - Inicializado: " + (s.inicializado ? "Sim" : "Não");
 }
 
-// percorrer da pilha mais interna para a mais externa
-static void marcarUsadoPorNome(
-    const std::string& nome,
-    std::vector<std::vector<Simbolo>>& pilhaEscopos,
-    std::vector<Simbolo>& tabelaSimbolo
-    ) {
-    if (nome.empty()) return;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (auto& simbolo : *it) {
-            if (simbolo.nome == nome) {
-                simbolo.usado = true;
-                for (auto& s : tabelaSimbolo)
-                    if (s.nome == simbolo.nome && s.tipo == simbolo.tipo && s.escopo == simbolo.escopo)
-                        s.usado = true;
-                return;
-            }
-        }
-    }
+// ===== Nomes internados =====
+Interner& Semantico::nomes() {
+    return nomes_ ? *nomes_ : proprio_;
 }
 
-static void marcarInicializadoPorNome(
-    const std::string& nome,
-    std::vector<std::vector<Simbolo>>& pilhaEscopos,
-    std::vector<Simbolo>& tabelaSimbolo
-    ) {
-    if (nome.empty()) return;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (auto& simbolo : *it) {
-            if (simbolo.nome == nome) {
-                simbolo.inicializado = true;
-                std::cerr << "Marcando " << nome << " como inicializado no escopo " << simbolo.escopo << std::endl;
-                for (auto& s : tabelaSimbolo)
-                    if (s.nome == simbolo.nome && s.tipo == simbolo.tipo && s.escopo == simbolo.escopo)
-                        s.inicializado = true;
-                return;
-            }
-        }
-    }
+const Interner& Semantico::nomes() const {
+    return nomes_ ? *nomes_ : proprio_;
 }
 
-bool Semantico::buscarSimbolo(const std::string& nome, Simbolo& out) const {
-    if (nome.empty()) return false;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (const auto& s : *it) {
-            if (s.nome == nome) {
-                out = s;
-                return true;
-            }
-        }
-    }
-    return false;
+// id do identificador: o do léxico quando o Interner é compartilhado
+Interner::Id Semantico::idDe(const Token& tok) {
+    if (nomes_ && tok.getSymbol() >= 0) return tok.getSymbol();
+    return nomes().intern(tok.getLexeme());
 }
 
+std::string Semantico::texto(Interner::Id id) const {
+    return id == Interner::NENHUM ? std::string() : std::string(nomes().texto(id));
+}
 
-// Nova função para marcar inicialização de elementos de vetor
-static void marcarElementoVetorInicializado(
-    const std::string& nome,
-    int /*indice*/,
-    std::vector<std::vector<Simbolo>>& pilhaEscopos,
-    std::vector<Simbolo>& tabelaSimbolo
-    ) {
-    if (nome.empty()) return;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (auto& simbolo : *it) {
-            if (simbolo.nome == nome && simbolo.modalidade == "vetor") {
-                simbolo.inicializado = true;
-                std::cerr << "Marcando elemento de " << nome << " como inicializado no escopo " << simbolo.escopo << std::endl;
-                for (auto& s : tabelaSimbolo)
-                    if (s.nome == simbolo.nome && s.tipo == simbolo.tipo && s.escopo == simbolo.escopo)
-                        s.inicializado = true;
-                return;
-            }
-        }
-    }
+// ===== Tabela de escopos =====
+// ligacaoAtual_[id] é a ligação mais interna do nome; cada ligação guarda a
+// que ela sombreia. Fechar um escopo desempilha as ligações criadas depois da
+// marca do escopo, restaurando as anteriores.
+int Semantico::ligacaoDe(Interner::Id nome) const {
+    if (nome < 0 || static_cast<std::size_t>(nome) >= ligacaoAtual_.size()) return -1;
+    return ligacaoAtual_[nome];
 }
 
-bool Semantico::existeNoEscopoAtual(const std::string& nome) const {
-    if (pilhaEscopos.empty()) return false;
-    const auto& esc = pilhaEscopos.back();
-    return std::any_of(esc.begin(), esc.end(), [&](const Simbolo& s){ return s.nome == nome; });
+int Semantico::buscarIndice(Interner::Id nome) const {
+    const int l = ligacaoDe(nome);
+    return l < 0 ? -1 : ligacoes_[l].simbolo;
 }
-bool Semantico::existe(const std::string& nome) const {
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        const auto& esc = *it;
-        if (std::any_of(esc.begin(), esc.end(), [&](const Simbolo& s){ return s.nome == nome; }))
-            return true;
+
+void Semantico::ligar(Interner::Id nome, int indice) {
+    if (static_cast<std::size_t>(nome) >= ligacaoAtual_.size())
+        ligacaoAtual_.resize(std::max<std::size_t>(nomes().size(), nome + 1), -1);
+    int& atual = ligacaoAtual_[nome];
+    ligacoes_.push_back({ indice, atual });
+    atual = static_cast<int>(ligacoes_.size()) - 1;
+}
+
+// Promove o último ID declarado para FUNÇÃO
+void Semantico::promoverParaFuncao(Interner::Id nomeFunc) {
+    if (!existeNoEscopoAtual(nomeFunc)) return;
+    Simbolo& s = tabelaSimbolo[buscarIndice(nomeFunc)];
+    s.modalidade = Modalidade::Funcao;
+    s.escopo = ESCOPO_GLOBAL;
+    s.inicializado = true;
+}
+
+// símbolo visível mais interno
+void Semantico::marcarUsadoPorNome(Interner::Id nome) {
+    const int i = buscarIndice(nome);
+    if (i >= 0)
+        tabelaSimbolo[i].usado = true;
+}
+
+void Semantico::marcarInicializadoPorNome(Interner::Id nome) {
+    const int i = buscarIndice(nome);
+    if (i >= 0) {
+        tabelaSimbolo[i].inicializado = true;
+        std::cerr << "Marcando " << tabelaSimbolo[i].nome << " como inicializado no escopo " << nomeEscopo(tabelaSimbolo[i].escopo) << std::endl;
     }
-    return false;
+}
+
+bool Semantico::buscarSimbolo(Interner::Id nome, Simbolo& out) const {
+    const int i = buscarIndice(nome);
+    if (i < 0) return false;
+    out = tabelaSimbolo[i];
+    return true;
+}
+
+bool Semantico::existeNoEscopoAtual(Interner::Id nome) const {
+    if (marcasEscopo_.empty()) return false;
+    const int l = ligacaoDe(nome);
+    return l >= 0 && static_cast<std::size_t>(l) >= marcasEscopo_.back();
+}
+bool Semantico::existe(Interner::Id nome) const {
+    return buscarIndice(nome) >= 0;
 }
 
 // impede sombreamento na MESMA FUNÇÃO
-bool Semantico::existeNoEscopoDaFuncaoAtual(const std::string& nome) const {
-    const std::string esc = escopoAtual();
-    if (esc == "global") return false;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (const auto& s : *it) {
-            if (s.nome == nome && s.escopo == esc) {
-                return true;
-            }
-        }
+bool Semantico::existeNoEscopoDaFuncaoAtual(Interner::Id nome) const {
+    const int esc = escopoAtual();
+    if (esc == ESCOPO_GLOBAL) return false;
+    for (int l = ligacaoDe(nome); l >= 0; l = ligacoes_[l].anterior) {
+        if (tabelaSimbolo[ligacoes_[l].simbolo].escopo == esc)
+            return true;
     }
     return false;
 }
 
-void Semantico::marcarUltimoDeclaradoComoVetor(const std::string& nome) {
-    if (nome.empty() || pilhaEscopos.empty()) return;
-    auto& escopoAtualRef = pilhaEscopos.back();
-    for (auto& sim : escopoAtualRef) {
-        if (sim.nome == nome) {
-            sim.modalidade = "vetor";
-            for (auto& s : tabelaSimbolo)
-                if (s.nome == sim.nome && s.tipo == sim.tipo && s.escopo == sim.escopo)
-                    s.modalidade = "vetor";
-            return;
-        }
-    }
+void Semantico::marcarUltimoDeclaradoComoVetor(Interner::Id nome) {
+    if (!existeNoEscopoAtual(nome)) return;
+    tabelaSimbolo[buscarIndice(nome)].modalidade = Modalidade::Vetor;
 }
 
-// Escopo atual: "global" ou nome da função do topo da pilha
-std::string Semantico::escopoAtual() const {
+// Escopo atual: global ou a função do topo da pilha
+int Semantico::escopoAtual() const {
     if (!pilhaFuncoes.empty()) return pilhaFuncoes.back();
-    return "global";
+    return ESCOPO_GLOBAL;
+}
+
+// dona dos parâmetros em leitura: a função visível com o nome da assinatura
+int Semantico::escopoDaFuncaoEmConstrucao() const {
+    if (funcEmConstrucao_ == Interner::NENHUM) return ESCOPO_GLOBAL;
+    const int i = buscarIndice(funcEmConstrucao_);
+    return i < 0 ? ESCOPO_GLOBAL : i;
+}
+
+std::string Semantico::nomeEscopo(int escopo) const {
+    return escopo == ESCOPO_GLOBAL ? std::string("global") : tabelaSimbolo[escopo].nome;
 }
 
-void Semantico::beginDeclaracao(const std::string& tipo) {
+void Semantico::beginDeclaracao(TipoBase tipo) {
     modoDeclaracao   = true;
     tipoAtual        = tipo;
     lastDeclaredPos  = -1;
-    ultimoDeclaradoNome.clear();
+    ultimoDeclaradoNome = Interner::NENHUM;
     // ao iniciar uma declaração, zera flags de lista de init
     inInitList = false;
     pendingInitList = false;
@@ -255,9 +232,9 @@ void Semantico::beginDeclaracao(const std::string& tipo) {
 
 void Semantico::endDeclaracao() {
     modoDeclaracao   = false;
-    tipoAtual.clear();
+    tipoAtual        = TipoBase::T_DESCONHECIDO;
     lastDeclaredPos  = -1;
-    ultimoDeclaradoNome.clear();
+    ultimoDeclaradoNome = Interner::NENHUM;
     // garante estado consistente
     inInitList = false;
     pendingInitList = false;
@@ -265,92 +242,91 @@ void Semantico::endDeclaracao() {
 }
 
 // Semantico: declarar/usar/fechar
-void Semantico::declarar(const Token* tok) {
-    if (!tok) return;
-    if (tok->getId() != t_ID) return;
+void Semantico::declarar(const Token& tok) {
+    if (tok.getId() != t_ID) return;
 
-    const std::string nome = tok->getLexeme();
-    if (nome.empty()) return;
+    if (tok.getLexeme().empty()) return;
+    const Interner::Id id = idDe(tok);
+    const std::string nome(tok.getLexeme());
 
-    if (pilhaEscopos.empty()) abrirEscopo();
+    if (marcasEscopo_.empty()) abrirEscopo();
 
     // (1) Duplicidade no BLOCO atual
-    if (existeNoEscopoAtual(nome)) {
+    if (existeNoEscopoAtual(id)) {
         throw SemanticError("Símbolo '" + nome + "' já existe neste escopo",
-                            tok->getPosition());
+                            tok.getPosition());
     }
 
     // (2) Proibir sombreamento dentro da MESMA FUNÇÃO
-    if (escopoAtual() != "global" && existeNoEscopoDaFuncaoAtual(nome)) {
+    if (escopoAtual() != ESCOPO_GLOBAL && existeNoEscopoDaFuncaoAtual(id)) {
         throw SemanticError(
-            "Símbolo '" + nome + "' já foi declarado anteriormente na função '" + escopoAtual() + "'.",
-            tok->getPosition()
+            "Símbolo '" + nome + "' já foi declarado anteriormente na função '" + nomeEscopo(escopoAtual()) + "'.",
+            tok.getPosition()
             );
     }
 
-    if (tipoAtual.empty()) {
+    if (tipoAtual == TipoBase::T_DESCONHECIDO) {
         throw SemanticError("Declaração de '" + nome + "' sem tipo corrente",
-                            tok->getPosition());
+                            tok.getPosition());
     }
 
     Simbolo sim;
     sim.tipo = tipoAtual;
     sim.nome = nome;
+    sim.nomeId = id;
     sim.usado = false;
     sim.inicializado = false;
-    sim.modalidade = "variavel";
+    sim.modalidade = Modalidade::Variavel;
     sim.escopo = escopoAtual();
 
-    pilhaEscopos.back().push_back(sim);
     tabelaSimbolo.push_back(sim);
+    ligar(id, static_cast<int>(tabelaSimbolo.size()) - 1);
 
-    g_ultimoIdVisto = nome;
-    g_ultimoIdAntesDaAtrib = nome;
-    ultimoDeclaradoNome = nome;
-}
-
-void Semantico::usar(const Token* tok) {
-    const std::string nome = tok->getLexeme();
-    if (nome.empty()) return;
-
-    bool encontrado = false;
-    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-        for (auto& simbolo : *it) {
-            if (simbolo.nome == nome) {
-                if (!simbolo.inicializado) {
-                    warn("Aviso: Símbolo '" + nome +
-                         "' (tipo: " + simbolo.tipo +
-                         ", escopo: " + simbolo.escopo +
-                         ") usado sem inicialização na posição " +
-                         std::to_string(tok->getPosition()));
-                }
-                simbolo.usado = true;
-                for (auto& s : tabelaSimbolo)
-                    if (s.nome == simbolo.nome && s.tipo == simbolo.tipo && s.escopo == simbolo.escopo)
-                        s.usado = true;
-                encontrado = true;
-                break;
-            }
-        }
-        if (encontrado) break;
+    ultimoIdVisto_ = id;
+    ultimoIdAntesDaAtrib_ = id;
+    ultimoDeclaradoNome = id;
+}
+
+void Semantico::usar(const Token& tok) {
+    if (tok.getLexeme().empty()) return;
+
+    const int i = buscarIndice(idDe(tok));
+    if (i < 0) {
+        throw SemanticError("'" + std::string(tok.getLexeme()) + "' não declarado neste escopo", tok.getPosition());
     }
-    if (!encontrado) {
-        throw SemanticError("'" + nome + "' não declarado neste escopo", tok->getPosition());
+
+    Simbolo& simbolo = tabelaSimbolo[i];
+    if (!simbolo.inicializado) {
+        warn("Aviso: Símbolo '" + simbolo.nome +
+             "' (tipo: " + tipoBaseToString(simbolo.tipo) +
+             ", escopo: " + nomeEscopo(simbolo.escopo) +
+             ") usado sem inicialização na posição " +
+             std::to_string(tok.getPosition()));
     }
+    simbolo.usado = true;
 }
 
 void Semantico::fecharEscopo() {
-    if (pilhaEscopos.empty()) return;
+    if (marcasEscopo_.empty()) return;
 
-    for (const auto& simbolo : pilhaEscopos.back()) {
+    const std::size_t marca = marcasEscopo_.back();
+    for (std::size_t l = marca; l < ligacoes_.size(); ++l) {
+        const Simbolo& simbolo = tabelaSimbolo[ligacoes_[l].simbolo];
         if (!simbolo.usado) {
             warn("Aviso: Símbolo '" + simbolo.nome +
-                 "' (tipo: " + simbolo.tipo +
-                 ", escopo: " + simbolo.escopo +
+                 "' (tipo: " + tipoBaseToString(simbolo.tipo) +
+                 ", escopo: " + nomeEscopo(simbolo.escopo) +
                  ") declarado mas não usado.");
         }
     }
-    pilhaEscopos.pop_back();
+
+    // desfaz as ligações do escopo, da mais nova para a mais antiga
+    while (ligacoes_.size() > marca) {
+        const Ligacao& l = ligacoes_.back();
+        ligacaoAtual_[tabelaSimbolo[l.simbolo].nomeId] = l.anterior;
+        ligacoes_.pop_back();
+    }
+    marcasEscopo_.pop_back();
 
     if (!pilhaEscopoEhFuncao.empty()) {
         bool eraFunc = pilhaEscopoEhFuncao.back();
@@ -364,8 +340,8 @@ void Semantico::verificarNaoUsados() const {
     for (const auto& simbolo : tabelaSimbolo) {
         if (!simbolo.usado) {
             warn("Aviso: Símbolo '" + simbolo.nome +
-                 "' (tipo: " + simbolo.tipo +
-                 ", escopo: " + simbolo.escopo +
+                 "' (tipo: " + tipoBaseToString(simbolo.tipo) +
+                 ", escopo: " + nomeEscopo(simbolo.escopo) +
                  ") declarado mas não usado.");
         }
     }
@@ -384,10 +360,10 @@ void Semantico::error(const std::string& msg) const {
     if (logger_) logger_(std::string("Erro: ") + msg);
 }
 
-void Semantico::executeAction(int action, const Token* token)
+void Semantico::executeAction(int action, const Token& token)
 {
-    if (token) {
-        const int id = token->getId();
+    if (token.getId() != EPSILON) {
+        const int id = token.getId();
         switch (id) {
         // TIPOS
         case t_KEY_INT:
@@ -398,65 +374,64 @@ void Semantico::executeAction(int action, const Token* token)
         case t_KEY_DOUBLE:
         case t_KEY_LONG:
         case t_KEY_VOID:
-            beginDeclaracao(token->getLexeme());
+            beginDeclaracao(tipoDoToken(id));
             break;
         // PARENTS (assinatura)
         case t_DELIM_PARENTESESE:
             if (modoDeclaracao) {
-                g_inParamList = true;
-                g_paramBuffer.clear();
-                g_funcEmConstrucao = g_ultimoIdVisto;
-                promoverParaFuncao(g_funcEmConstrucao, pilhaEscopos, tabelaSimbolo);
+                inParamList_ = true;
+                paramBuffer_.clear();
+                funcEmConstrucao_ = ultimoIdVisto_;
+                promoverParaFuncao(funcEmConstrucao_);
             }
             break;
         case t_DELIM_PARENTESESD:
-            if (g_inParamList) {
+            if (inParamList_) {
                 // fim da lista de parâmetros da DECLARAÇÃO de função
-                g_inParamList = false;
-                g_nextBraceIsFuncBody = true;
+                inParamList_ = false;
+                nextBraceIsFuncBody_ = true;
                 // REGISTRA ASSINATURA DA FUNÇÃO
-                if (!g_funcEmConstrucao.empty()) {
+                if (funcEmConstrucao_ != Interner::NENHUM) {
                     // 1) Descobrir tipo de retorno da função
-                    std::string retType;
-                    for (auto it = pilhaEscopos.rbegin(); it != pilhaEscopos.rend(); ++it) {
-                        for (const auto& s : *it) {
-                            if (s.nome == g_funcEmConstrucao && s.modalidade == "funcao" && s.escopo == "global") {
-                                retType = s.tipo;
-                                break;
-                            }
+                    TipoBase retType = TipoBase::T_DESCONHECIDO;
+                    for (int l = ligacaoDe(funcEmConstrucao_); l >= 0; l = ligacoes_[l].anterior) {
+                        const Simbolo& s = tabelaSimbolo[ligacoes_[l].simbolo];
+                        if (s.modalidade == Modalidade::Funcao && s.escopo == ESCOPO_GLOBAL) {
+                            retType = s.tipo;
+                            break;
                         }
-                        if (!retType.empty()) break;
                     }
-                    if (retType.empty()) {
+                    if (retType == TipoBase::T_DESCONHECIDO) {
                         // fallback se por algum motivo não achar
-                        retType = "int";
+                        retType = TipoBase::T_INT;
                     }
                     FuncSignature sig;
                     sig.returnType = retType;
                     // 2) Tipos dos parâmetros (em ordem)
                     sig.paramTypes.clear();
-                    // Preferência: usar g_paramBuffer se ele tiver algo
-                    if (!g_paramBuffer.empty()) {
-                        for (const auto& p : g_paramBuffer) {
-                            sig.paramTypes.push_back(p.tipo);
+                    // Preferência: usar paramBuffer_ se ele tiver algo
+                    if (!paramBuffer_.empty()) {
+                        for (int p : paramBuffer_) {
+                            sig.paramTypes.push_back(tabelaSimbolo[p].tipo);
                         }
                     } else {
                         // fallback robusto: pega da tabela de símbolos
                         // todos os símbolos que são parâmetros da função
+                        const int dona = escopoDaFuncaoEmConstrucao();
                         for (const auto& s : tabelaSimbolo) {
-                            if (s.modalidade == "parametro" &&
-                                s.escopo == g_funcEmConstrucao)
+                            if (s.modalidade == Modalidade::Parametro &&
+                                s.escopo == dona)
                             {
                                 sig.paramTypes.push_back(s.tipo);
                             }
                         }
                     }
                     // 3) Salva no mapa (detecção de redeclaração opcional)
-                    auto it = funcoes_.find(g_funcEmConstrucao);
+                    auto it = funcoes_.find(funcEmConstrucao_);
                     if (it != funcoes_.end()) {
-                        error("Função '" + g_funcEmConstrucao + "' já foi declarada anteriormente.");
+                        error("Função '" + texto(funcEmConstrucao_) + "' já foi declarada anteriormente.");
                     } else {
-                        funcoes_[g_funcEmConstrucao] = sig;
+                        funcoes_[funcEmConstrucao_] = sig;
                     }
                 }
             }
@@ -465,51 +440,51 @@ void Semantico::executeAction(int action, const Token* token)
             break;
         // IDENTIFICADORES
         case t_ID:
-            if (g_inParamList) {
-                if (tipoAtual.empty())
-                    throw SemanticError("Parâmetro sem tipo declarado", token->getPosition());
-                if (lastDeclaredPos != token->getPosition()) {
+            if (inParamList_) {
+                if (tipoAtual == TipoBase::T_DESCONHECIDO)
+                    throw SemanticError("Parâmetro sem tipo declarado", token.getPosition());
+                if (lastDeclaredPos != token.getPosition()) {
                     Simbolo p;
-                    p.tipo = tipoAtual; p.nome = token->getLexeme();
+                    p.tipo = tipoAtual; p.nome = token.getLexeme();
+                    p.nomeId = idDe(token);
                     p.usado = false; p.inicializado = true;
-                    p.modalidade = "parametro";
-                    p.escopo = g_funcEmConstrucao.empty() ? "global" : g_funcEmConstrucao;
-                    g_paramBuffer.push_back(p);
+                    p.modalidade = Modalidade::Parametro;
+                    p.escopo = escopoDaFuncaoEmConstrucao();
                     tabelaSimbolo.push_back(p);
-                    lastDeclaredPos = token->getPosition();
+                    paramBuffer_.push_back(static_cast<int>(tabelaSimbolo.size()) - 1);
+                    lastDeclaredPos = token.getPosition();
                 }
-            } else if (modoDeclaracao && lastDeclaredPos != token->getPosition()) {
+            } else if (modoDeclaracao && lastDeclaredPos != token.getPosition()) {
                 declarar(token);
-                lastDeclaredPos = token->getPosition();
-                g_ultimoIdVisto = token->getLexeme();
-                g_ultimoIdAntesDaAtrib = g_ultimoIdVisto;
-                ultimoDeclaradoNome = g_ultimoIdVisto;
+                lastDeclaredPos = token.getPosition();
+                ultimoIdVisto_ = idDe(token);
+                ultimoIdAntesDaAtrib_ = ultimoIdVisto_;
+                ultimoDeclaradoNome = ultimoIdVisto_;
             } else {
                 usar(token);
-                g_ultimoIdVisto = token->getLexeme();
-                g_ultimoIdAntesDaAtrib = g_ultimoIdVisto; // Atualiza antes da atribuição
+                ultimoIdVisto_ = idDe(token);
+                ultimoIdAntesDaAtrib_ = ultimoIdVisto_; // Atualiza antes da atribuição
                 // Se estamos em argumentos de chamada, usa o tipo do ID na expressão atual
                 if (inCallArgs_) {
                     Simbolo sim;
-                    if (buscarSimbolo(token->getLexeme(), sim)) {
-                        TipoBase t = stringToTipoBase(sim.tipo);
-                        currentExprType_ = promoverTipos(currentExprType_, t);
+                    if (buscarSimbolo(ultimoIdVisto_, sim)) {
+                        currentExprType_ = promoverTipos(currentExprType_, sim.tipo);
                     }
                 }
             }
             break;
         // VÍRGULA
         case t_DELIM_VIRGULA:
-            if (modoDeclaracao || g_inParamList) {
+            if (modoDeclaracao || inParamList_) {
                 lastDeclaredPos = -1;
-                ultimoDeclaradoNome.clear();
+                ultimoDeclaradoNome = Interner::NENHUM;
             }
             break;
         // PONTO E VÍRGULA
         case t_DELIM_PONTOVIRGULA:
             endDeclaracao();
-            g_ultimoIdVisto.clear();
-            g_ultimoIdAntesDaAtrib.clear();
+            ultimoIdVisto_ = Interner::NENHUM;
+            ultimoIdAntesDaAtrib_ = Interner::NENHUM;
             break;
         // CHAVES
         case t_DELIM_CHAVEE: {
@@ -520,19 +495,18 @@ void Semantico::executeAction(int action, const Token* token)
             }
             abrirEscopo();
             bool ehFunc = false;
-            if (g_nextBraceIsFuncBody) {
+            if (nextBraceIsFuncBody_) {
                 ehFunc = true;
-                g_nextBraceIsFuncBody = false;
-                if (!g_funcEmConstrucao.empty())
-                    pilhaFuncoes.push_back(g_funcEmConstrucao);
-                auto& escopoAtual = pilhaEscopos.back();
-                for (const auto& p : g_paramBuffer) {
-                    bool dup = std::any_of(escopoAtual.begin(), escopoAtual.end(),
-                                           [&](const Simbolo& s){ return s.nome == p.nome; });
-                    if (!dup) escopoAtual.push_back(p);
+                nextBraceIsFuncBody_ = false;
+                if (funcEmConstrucao_ != Interner::NENHUM)
+                    pilhaFuncoes.push_back(escopoDaFuncaoEmConstrucao());
+                // parâmetros ficam visíveis no corpo (o primeiro de cada nome)
+                for (int p : paramBuffer_) {
+                    const Interner::Id nome = tabelaSimbolo[p].nomeId;
+                    if (!existeNoEscopoAtual(nome)) ligar(nome, p);
                 }
-                g_paramBuffer.clear();
-                ultimoDeclaradoNome.clear();
+                paramBuffer_.clear();
+                ultimoDeclaradoNome = Interner::NENHUM;
             }
             pilhaEscopoEhFuncao.push_back(ehFunc);
             break;
@@ -542,33 +516,33 @@ void Semantico::executeAction(int action, const Token* token)
                 if (initListDepth > 0) --initListDepth;
                 if (initListDepth == 0) {
                     inInitList = false; pendingInitList = false;
-                    if (!ultimoDeclaradoNome.empty())
-                        marcarInicializadoPorNome(ultimoDeclaradoNome, pilhaEscopos, tabelaSimbolo);
+                    if (ultimoDeclaradoNome != Interner::NENHUM)
+                        marcarInicializadoPorNome(ultimoDeclaradoNome);
                 }
                 break;
             }
             fecharEscopo();
-            g_ultimoIdVisto.clear();
-            g_ultimoIdAntesDaAtrib.clear();
+            ultimoIdVisto_ = Interner::NENHUM;
+            ultimoIdAntesDaAtrib_ = Interner::NENHUM;
             break;
         // '='
         case t_OPR_ATRIB:
             if (modoDeclaracao) {
                 pendingInitList = true;
-                if (!ultimoDeclaradoNome.empty()) {
-                    marcarInicializadoPorNome(ultimoDeclaradoNome, pilhaEscopos, tabelaSimbolo);
-                } else if (!g_ultimoIdVisto.empty()) {
-                    marcarInicializadoPorNome(g_ultimoIdVisto, pilhaEscopos, tabelaSimbolo);
+                if (ultimoDeclaradoNome != Interner::NENHUM) {
+                    marcarInicializadoPorNome(ultimoDeclaradoNome);
+                } else if (ultimoIdVisto_ != Interner::NENHUM) {
+                    marcarInicializadoPorNome(ultimoIdVisto_);
                 }
             }
             break;
         // '['
         case t_DELIM_COLCHETESE:
             if (modoDeclaracao) {
-                const std::string alvo = !ultimoDeclaradoNome.empty() ? ultimoDeclaradoNome : g_ultimoIdVisto;
+                const Interner::Id alvo = ultimoDeclaradoNome != Interner::NENHUM ? ultimoDeclaradoNome : ultimoIdVisto_;
                 marcarUltimoDeclaradoComoVetor(alvo);
             } else {
-                marcarUsadoPorNome(g_ultimoIdVisto, pilhaEscopos, tabelaSimbolo);
+                marcarUsadoPorNome(ultimoIdVisto_);
             }
             break;
         // (apenas reconhece os tokens; código de desvio está no MainWindow/emitirTextBasico)
@@ -613,7 +587,7 @@ void Semantico::executeAction(int action, const Token* token)
             }
             break;
         default:
-            warn("Token inesperado: " + token->getLexeme() + " na posição " + std::to_string(token->getPosition()));
+            warn("Token inesperado: " + std::string(token.getLexeme()) + " na posição " + std::to_string(token.getPosition()));
             if (id != t_DELIM_PONTOVIRGULA && id != t_DELIM_CHAVEE && id != t_DELIM_CHAVED) {
                 return; // Ignorar e continuar
             }
@@ -625,39 +599,37 @@ void Semantico::executeAction(int action, const Token* token)
 
     switch (action) {
     case 2: {
-        if (!token) return;
         // evita duplicar o mesmo ID na mesma posição
-        if (lastDeclaredPos == token->getPosition()) return;
+        if (lastDeclaredPos == token.getPosition()) return;
         // CASO 1: estamos dentro da lista de parâmetros da função
-        if (g_inParamList) {
-            if (tipoAtual.empty()) {
-                throw SemanticError("Parâmetro sem tipo declarado", token->getPosition());
+        if (inParamList_) {
+            if (tipoAtual == TipoBase::T_DESCONHECIDO) {
+                throw SemanticError("Parâmetro sem tipo declarado", token.getPosition());
             }
             Simbolo p;
             p.tipo = tipoAtual;
-            p.nome = token->getLexeme();
+            p.nome = token.getLexeme();
+            p.nomeId = idDe(token);
             p.usado = false;
             p.inicializado = true; // parâmetro nasce inicializado
-            p.modalidade = "parametro";
-            p.escopo = g_funcEmConstrucao.empty()
-                           ? "global"
-                           : g_funcEmConstrucao; // nome da função
-            // guarda na lista temporária de parâmetros da função
-            g_paramBuffer.push_back(p);
-            // e também na tabela global de símbolos (para relatórios, etc.)
+            p.modalidade = Modalidade::Parametro;
+            p.escopo = escopoDaFuncaoEmConstrucao(); // função dona
+            // guarda na tabela global de símbolos (para relatórios, etc.)
+            // e o índice na lista temporária de parâmetros da função
             tabelaSimbolo.push_back(p);
-            lastDeclaredPos = token->getPosition();
-            g_ultimoIdVisto = p.nome;
-            g_ultimoIdAntesDaAtrib = g_ultimoIdVisto;
-            ultimoDeclaradoNome = g_ultimoIdVisto;
+            paramBuffer_.push_back(static_cast<int>(tabelaSimbolo.size()) - 1);
+            lastDeclaredPos = token.getPosition();
+            ultimoIdVisto_ = p.nomeId;
+            ultimoIdAntesDaAtrib_ = ultimoIdVisto_;
+            ultimoDeclaradoNome = ultimoIdVisto_;
         }
         // CASO 2: declaração "normal" (variável global/local)
         else if (modoDeclaracao) {
             declarar(token);
-            lastDeclaredPos = token->getPosition();
-            g_ultimoIdVisto = token->getLexeme();
-            g_ultimoIdAntesDaAtrib = g_ultimoIdVisto;
-            ultimoDeclaradoNome = g_ultimoIdVisto;
+            lastDeclaredPos = token.getPosition();
+            ultimoIdVisto_ = idDe(token);
+            ultimoIdAntesDaAtrib_ = ultimoIdVisto_;
+            ultimoDeclaradoNome = ultimoIdVisto_;
         }
         return;
     }
@@ -668,33 +640,26 @@ void Semantico::executeAction(int action, const Token* token)
         endDeclaracao();
         return;
     case 10: // ID[expr] -> vetor
-        if (!ultimoDeclaradoNome.empty())
+        if (ultimoDeclaradoNome != Interner::NENHUM)
             marcarUltimoDeclaradoComoVetor(ultimoDeclaradoNome);
         return;
     case 11:
-        if (!ultimoDeclaradoNome.empty()) {
-            marcarInicializadoPorNome(ultimoDeclaradoNome, pilhaEscopos, tabelaSimbolo);
+        if (ultimoDeclaradoNome != Interner::NENHUM) {
+            marcarInicializadoPorNome(ultimoDeclaradoNome);
         }
         return;
     case 12: // ID[...] = { ... }
-        if (!ultimoDeclaradoNome.empty())
-            marcarInicializadoPorNome(ultimoDeclaradoNome, pilhaEscopos, tabelaSimbolo);
+        if (ultimoDeclaradoNome != Interner::NENHUM)
+            marcarInicializadoPorNome(ultimoDeclaradoNome);
         inInitList = false; initListDepth = 0; pendingInitList = false;
         return;
     case 13: // Marcar inicialização após atribuição
-        if (!g_ultimoIdAntesDaAtrib.empty()) {
-            if (g_ultimoIdVisto.find('[') != std::string::npos) {
-                // Trata atribuição a elemento de vetor (ex.: v[0] = 3)
-                std::string nomeVetor = g_ultimoIdAntesDaAtrib;
-                marcarElementoVetorInicializado(nomeVetor, -1, pilhaEscopos, tabelaSimbolo);
-            } else {
-                marcarInicializadoPorNome(g_ultimoIdAntesDaAtrib, pilhaEscopos, tabelaSimbolo);
-            }
-        }
+        if (ultimoIdAntesDaAtrib_ != Interner::NENHUM)
+            marcarInicializadoPorNome(ultimoIdAntesDaAtrib_);
         return;
     case 20: // ID da chamada de função
-        if (token) {
-            funcEmChamada_ = token->getLexeme();
+        if (token.getId() != EPSILON) {
+            funcEmChamada_ = idDe(token);
             // marca como usado (se não existir, 'usar' já acusa erro)
             usar(token);
         }
@@ -722,16 +687,17 @@ void Semantico::executeAction(int action, const Token* token)
     case 22: // fecha chamada: faz verificação
         if (inCallArgs_) {
             inCallArgs_ = false;
-            if (!funcEmChamada_.empty()) {
+            if (funcEmChamada_ != Interner::NENHUM) {
+                const std::string nomeFunc = texto(funcEmChamada_);
                 auto it = funcoes_.find(funcEmChamada_);
                 if (it == funcoes_.end()) {
-                    error("Chamada à função '" + funcEmChamada_ +
+                    error("Chamada à função '" + nomeFunc +
                           "' que não foi declarada como função.");
                 } else {
                     const FuncSignature& sig = it->second;
                     std::size_t esperados = sig.paramTypes.size();
                     std::cerr << "[DEBUG] Verificando chamada de '"
-                              << funcEmChamada_
+                              << nomeFunc
                               << "': esperados=" << esperados
                               << ", recebidos=" << callArgsCount_ << "\n";
                     for (std::size_t i = 0; i < callArgTypes_.size(); ++i) {
@@ -741,7 +707,7 @@ void Semantico::executeAction(int action, const Token* token)
                     // 1) Verifica QUANTIDADE
                     if ((std::size_t)callArgsCount_ != esperados) {
                         error(
-                            "Chamada à função '" + funcEmChamada_ +
+                            "Chamada à função '" + nomeFunc +
                             "' com quantidade incorreta de parâmetros. Esperados " +
                             std::to_string(esperados) +
                             ", recebidos " + std::to_string(callArgsCount_) + "."
@@ -750,16 +716,16 @@ void Semantico::executeAction(int action, const Token* token)
                         // 2) Verifica TIPO + ORDEM
                         if (callArgTypes_.size() != esperados) {
                             warn("Número de tipos de argumentos registrados não bate com a quantidade na função '" +
-                                 funcEmChamada_ + "'.");
+                                 nomeFunc + "'.");
                         } else {
                             for (std::size_t i = 0; i < esperados; ++i) {
-                                TipoBase esperadoT = stringToTipoBase(sig.paramTypes[i]);
+                                TipoBase esperadoT = sig.paramTypes[i];
                                 TipoBase recebidoT = callArgTypes_[i];
                                 if (!tiposCompativeis(esperadoT, recebidoT)) {
                                     error(
                                         "Tipo incompatível no parâmetro " + std::to_string(i + 1) +
-                                        " da função '" + funcEmChamada_ + "'. Esperado '" +
-                                        sig.paramTypes[i] + "', recebido '" +
+                                        " da função '" + nomeFunc + "'. Esperado '" +
+                                        tipoBaseToString(esperadoT) + "', recebido '" +
                                         tipoBaseToString(recebidoT) + "'."
                                         );
                                 }
@@ -768,7 +734,7 @@ void Semantico::executeAction(int action, const Token* token)
                     }
                 }
             }
-            funcEmChamada_.clear();
+            funcEmChamada_ = Interner::NENHUM;
             callArgsCount_ = 0;
             callArgTypes_.clear();
             currentExprType_ = TipoBase::T_DESCONHECIDO;
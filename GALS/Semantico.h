@@ -2,31 +2,17 @@
 #define SEMANTICO_H
 #include "Token.h"
 #include "SemanticError.h"
+#include "interner.h"
 
 class CodeGeneratorBIP;
 
 #include <vector>
 #include <string>
-#include <ostream>
 #include <algorithm>
 #include <functional>
-#include <map>
+#include <unordered_map>
 
-class Simbolo {
-public:
-    std::string tipo;
-    std::string nome;
-    bool usado = false;
-    bool inicializado = false;
-    std::string modalidade;   // "variavel", "parametro", "funcao", "vetor", etc.
-    bool isVetor = false;
-    int  vetorTam = 0;
-    std::string escopo;       // "global" ou nome_da_funcao
-
-    friend std::ostream& operator<<(std::ostream& os, const Simbolo& s);
-};
-
-enum class TipoBase {
+enum class TipoBase : unsigned char {
     T_INT,
     T_FLOAT,
     T_CHAR,
@@ -38,33 +24,88 @@ enum class TipoBase {
     T_DESCONHECIDO
 };
 
+enum class Modalidade : unsigned char {
+    Variavel,
+    Parametro,
+    Funcao,
+    Vetor
+};
+
+// escopo de um símbolo: índice (em tabelaSimbolo) da função dona, ou global
+constexpr int ESCOPO_GLOBAL = -1;
+
+class Simbolo {
+public:
+    Simbolo() : usado(false), inicializado(false), isVetor(false) {}
+
+    std::string nome;
+    int         nomeId   = -1;                     // id de 'nome' no Interner da compilação
+    int         escopo   = ESCOPO_GLOBAL;          // ESCOPO_GLOBAL ou índice da função
+    int         vetorTam = 0;
+    TipoBase    tipo       = TipoBase::T_DESCONHECIDO;
+    Modalidade  modalidade = Modalidade::Variavel;
+    bool        usado        : 1;
+    bool        inicializado : 1;
+    bool        isVetor      : 1;
+};
+
+// textos da tabela: só produzidos na hora de exibir
+std::string tipoBaseToString(TipoBase t);
+const char* modalidadeToString(Modalidade m);
+std::string nomeEscopo(const std::vector<Simbolo>& tabela, const Simbolo& s);
+std::string descreverSimbolo(const std::vector<Simbolo>& tabela, const Simbolo& s);
+
 struct FuncSignature {
-    std::string returnType;              // tipo de retorno: "int", "void", etc.
-    std::vector<std::string> paramTypes; // tipos dos parâmetros, na ordem
+    TipoBase              returnType = TipoBase::T_DESCONHECIDO;
+    std::vector<TipoBase> paramTypes;   // tipos dos parâmetros, na ordem
 };
 
 class Semantico {
 private:
     // Helpers de busca/escopo
-    bool existeNoEscopoAtual(const std::string& nome) const;
-    bool existe(const std::string& nome) const;
-    std::string escopoAtual() const;
+    bool existeNoEscopoAtual(Interner::Id nome) const;
+    bool existe(Interner::Id nome) const;
+    int  escopoAtual() const;                // ESCOPO_GLOBAL ou índice da função
+    int  escopoDaFuncaoEmConstrucao() const;
+    std::string nomeEscopo(int escopo) const;
 
     // busca de símbolo com retorno do símbolo encontrado
-    bool buscarSimbolo(const std::string& nome, Simbolo& out) const;
+    bool buscarSimbolo(Interner::Id nome, Simbolo& out) const;
 
     // impede sombreamento dentro da MESMA FUNÇÃO
-    bool existeNoEscopoDaFuncaoAtual(const std::string& nome) const;
+    bool existeNoEscopoDaFuncaoAtual(Interner::Id nome) const;
 
     // ===== Estado do analisador =====
     bool        modoDeclaracao = false;
-    std::string tipoAtual;
+    TipoBase    tipoAtual = TipoBase::T_DESCONHECIDO;   // T_DESCONHECIDO = sem tipo corrente
     int         lastDeclaredPos = -1;
-    std::string ultimoDeclaradoNome;
-
-    // pilhas de escopos/blocos e funções
-    std::vector<std::vector<Simbolo>> pilhaEscopos;
-    std::vector<std::string>          pilhaFuncoes;
+    Interner::Id ultimoDeclaradoNome = Interner::NENHUM;
+
+    // ===== Tabela de escopos (hash + log de desfazer) =====
+    // Cada ligação aponta para um índice de tabelaSimbolo: o símbolo visível
+    // no escopo e o do relatório são o mesmo objeto, nada precisa ser espelhado.
+    struct Ligacao {
+        int simbolo;    // índice em tabelaSimbolo
+        int anterior;   // ligação que este nome sombreava (-1 se nenhuma)
+    };
+    std::vector<int>         ligacaoAtual_;   // id do nome -> ligação mais interna (-1 se nenhuma)
+    std::vector<Ligacao>     ligacoes_;       // pilha de ligações (log de desfazer)
+    std::vector<std::size_t> marcasEscopo_;   // ligacoes_.size() na abertura de cada escopo
+
+    int  ligacaoDe(Interner::Id nome) const;
+    int  buscarIndice(Interner::Id nome) const;      // -1 se não visível
+    void ligar(Interner::Id nome, int indice);
+
+    // nomes: ids vindos do léxico (setInterner) ou internados aqui mesmo
+    Interner* nomes_ = nullptr;
+    Interner  proprio_;
+    Interner&       nomes();
+    const Interner& nomes() const;
+    Interner::Id idDe(const Token& tok);
+    std::string  texto(Interner::Id id) const;
+
+    // pilhas de funções
+    std::vector<int>                  pilhaFuncoes;   // índices das funções em tabelaSimbolo
     std::vector<bool>                 pilhaEscopoEhFuncao;
 
     // tabela linear opcional (histórico/relatório)
@@ -83,18 +124,18 @@ private:
 
     // declar/acabamento de declaração
     void endDeclaracao();
-    void beginDeclaracao(const std::string& tipo);
+    void beginDeclaracao(TipoBase tipo);
 
     // usado no case 10/colchetes: promove último declarado a "vetor"
-    void marcarUltimoDeclaradoComoVetor(const std::string& nome);
+    void marcarUltimoDeclaradoComoVetor(Interner::Id nome);
 
     CodeGeneratorBIP* codeGen = nullptr;
 
     // mapa de assinaturas de função
-    std::map<std::string, FuncSignature> funcoes_;
+    std::unordered_map<Interner::Id, FuncSignature> funcoes_;
 
     // estado para chamada de função
-    std::string funcEmChamada_;
+    Interner::Id funcEmChamada_ = Interner::NENHUM;
     bool        inCallArgs_    = false;
     int         callArgsCount_ = 0;
 
@@ -102,21 +143,38 @@ private:
     TipoBase currentExprType_ = TipoBase::T_DESCONHECIDO;
     std::vector<TipoBase> callArgTypes_;
 
+    // estado da declaração de função/parâmetros em andamento
+    // (por instância: vários Semantico podem rodar em threads diferentes)
+    Interner::Id         ultimoIdVisto_        = Interner::NENHUM;
+    Interner::Id         ultimoIdAntesDaAtrib_ = Interner::NENHUM;
+    bool                 inParamList_         = false;
+    bool                 nextBraceIsFuncBody_ = false;
+    Interner::Id         funcEmConstrucao_    = Interner::NENHUM;
+    std::vector<int>     paramBuffer_;   // índices em tabelaSimbolo
+
+    // marcações sobre o símbolo visível com esse nome
+    void promoverParaFuncao(Interner::Id nomeFunc);
+    void marcarUsadoPorNome(Interner::Id nome);
+    void marcarInicializadoPorNome(Interner::Id nome);
+
 public:
     // tabela “global” que você já usa
     std::vector<Simbolo> tabelaSimbolo;
 
     // API principal
-    void executeAction(int action, const Token* token);
-    void abrirEscopo() { pilhaEscopos.push_back({}); }
+    void executeAction(int action, const Token& token);
+    void abrirEscopo() { marcasEscopo_.push_back(ligacoes_.size()); }
     void fecharEscopo();
     void verificarNaoUsados() const;
 
     void setCodeGenerator(CodeGeneratorBIP* cg) { codeGen = cg; }
 
+    // compartilha o Interner do léxico: os ids dos tokens passam a valer aqui
+    void setInterner(Interner* in) { nomes_ = in; }
+
     // operações principais
-    void declarar(const Token* tok);
-    void usar(const Token* tok);
+    void declarar(const Token& tok);
+    void usar(const Token& tok);
 
     // logging/mensagens
     void setLogger(std::function<void(const std::string&)> fn) { logger_ = std::move(fn); }
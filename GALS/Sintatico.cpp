@@ -1,78 +1,90 @@
 #include "Sintatico.h"
 
-void Sintatico::parse(Lexico *scanner, Semantico *semanticAnalyser)
+void Sintatico::parse(Lexico *scanner, Semantico *semanticAnalyser, AstBuilder *astBuilder)
 {
     this->scanner = scanner;
     this->semanticAnalyser = semanticAnalyser;
+    this->astBuilder = astBuilder;
 
-    //Limpa a pilha
-    while (! stack.empty())
-        stack.pop();
-
-    stack.push(0);
+    if (astBuilder != 0)
+        astBuilder->reset();
 
-    if (previousToken != 0 && previousToken != currentToken)
-        delete previousToken;
-    previousToken = 0;
+    //Limpa a pilha
+    stack.clear();
+    stack.push_back(0);
 
-    if (currentToken != 0)
-        delete currentToken;
-    currentToken = scanner->nextToken();
+    previousToken = Token();
+    readToken();
 
+    // a flag de cancelamento só é consultada a cada 1024 passos
+    unsigned passos = 0;
     while ( ! step() )
-        ;
+    {
+        if (cancelar != 0 && (++passos & 1023) == 0 && cancelar->load(std::memory_order_relaxed))
+            throw CancelledError();
+    }
 }
 
-bool Sintatico::step()
+// lê o próximo token; no fim da entrada sintetiza o DOLLAR
+void Sintatico::readToken()
 {
-    if (currentToken == 0) //Fim de Sentença
-    {
-        int pos = 0;
-        if (previousToken != 0)
-            pos = previousToken->getPosition() + previousToken->getLexeme().size();
+    if (scanner->nextToken(currentToken))
+        return;
 
-        currentToken = new Token(DOLLAR, "$", pos);
-    }
+    int pos = 0;
+    if (previousToken.getId() != EPSILON)
+        pos = previousToken.getPosition() + (int) previousToken.getLexeme().size();
+
+    currentToken = Token(DOLLAR, "$", pos);
+}
 
-    int token = currentToken->getId();
-    int state = stack.top();
+bool Sintatico::step()
+{
+    int token = currentToken.getId();
+    int state = stack.back();
 
-    const int* cmd = PARSER_TABLE[state][token-1];
+    unsigned short cmd = actionFor(state, token);
+    int value = actionValue(cmd);
 
-    switch (cmd[0])
+    switch (actionKind(cmd))
     {
         case SHIFT:
         {
-            stack.push(cmd[1]);
-            if (previousToken != 0)
-                delete previousToken;
+            stack.push_back(value);
+            if (astBuilder != 0)
+                astBuilder->shift(currentToken);
             previousToken = currentToken;
-            currentToken = scanner->nextToken();
+            readToken();
             return false;
         }
         case REDUCE:
         {
-            const int* prod = PRODUCTIONS[cmd[1]];
+            const unsigned char* prod = PRODUCTIONS[value];
+
+            stack.resize(stack.size() - prod[1]);
 
-            for (int i=0; i<prod[1]; i++)
-                stack.pop();
+            if (astBuilder != 0)
+                astBuilder->reduce(value, prod[1]);
 
-            int oldState = stack.top();
-            stack.push(PARSER_TABLE[oldState][prod[0]-1][1]);
+            int oldState = stack.back();
+            stack.push_back(goTo(oldState, prod[0]));
             return false;
         }
         case ACTION:
         {
-            int action = FIRST_SEMANTIC_ACTION + cmd[1] - 1;
-            stack.push(PARSER_TABLE[state][action][1]);
-            semanticAnalyser->executeAction(cmd[1], previousToken);
+            stack.push_back(goTo(state, FIRST_SEMANTIC_ACTION + value));
+            if (astBuilder != 0)
+                astBuilder->action();
+            semanticAnalyser->executeAction(value, previousToken);
             return false;
         }
         case ACCEPT:
+            if (astBuilder != 0)
+                astBuilder->accept();
             return true;
 
         case ERROR:
-            throw SyntacticError(PARSER_ERROR[state], currentToken->getPosition());
+            throw SyntacticError(PARSER_ERROR[state], currentToken.getPosition());
     }
     return false;
 }
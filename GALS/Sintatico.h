@@ -6,30 +6,48 @@
 #include "Lexico.h"
 #include "Semantico.h"
 #include "SyntacticError.h"
+#include "CancelledError.h"
+#include "ast.h"
 
-#include <stack>
+#include <atomic>
+#include <vector>
 
 class Sintatico
 {
 public:
-    Sintatico() : previousToken(0), currentToken(0) { }
+    Sintatico() : astBuilder(0), cancelar(0) { }
 
-    ~Sintatico()
-    {
-        if (previousToken != 0 && previousToken != currentToken) delete previousToken;
-        if (currentToken != 0)  delete currentToken;
-    }
+    // astBuilder (opcional) recebe shifts/reduções e monta a AST no mesmo parse
+    void parse(Lexico *scanner, Semantico *semanticAnalyser, AstBuilder *astBuilder = 0);
 
-    void parse(Lexico *scanner, Semantico *semanticAnalyser);
+    // se a flag ficar true durante o parse, lança CancelledError
+    void setCancelamento(const std::atomic<bool> *flag) { cancelar = flag; }
 
 private:
-    std::stack<int> stack;
-    Token *previousToken;
-    Token *currentToken;
+    std::vector<int> stack;
+    Token previousToken;     // tokens por valor: nada a liberar
+    Token currentToken;
     Lexico *scanner;
     Semantico *semanticAnalyser;
+    AstBuilder *astBuilder;
+    const std::atomic<bool> *cancelar;
 
+    void readToken();
     bool step();
+
+    // consultas O(1) na tabela compactada (ver Constants.h)
+    static unsigned short actionFor(int state, int token)
+    {
+        int i = PARSER_ACTION_BASE[state] + token - 1;
+        return PARSER_ACTION_CHECK[i] == state ? PARSER_ACTION_NEXT[i] : PARSER_ACTION_DEFAULT[state];
+    }
+
+    static int goTo(int state, int symbol)
+    {
+        int column = symbol - FIRST_NON_TERMINAL;
+        int i = PARSER_GOTO_BASE[column] + state;
+        return PARSER_GOTO_CHECK[i] == column ? PARSER_GOTO_NEXT[i] : PARSER_GOTO_DEFAULT[column];
+    }
 };
 
 #endif
@@ -3,22 +3,30 @@
 
 #include "Constants.h"
 
-#include <string>
+#include <string_view>
 
+// Token por valor: o lexema é uma visão do buffer de entrada do Lexico,
+// então nenhum token aloca memória. Válido enquanto a entrada do Lexico
+// não for trocada.
 class Token
 {
 public:
-    Token(TokenId id, const std::string &lexeme, int position)
-      : id(id), lexeme(lexeme), position(position) { }
+    Token() : id(EPSILON), position(-1), symbol(-1) { }
+    Token(TokenId id, std::string_view lexeme, int position, int symbol = -1)
+      : id(id), lexeme(lexeme), position(position), symbol(symbol) { }
 
     TokenId getId() const { return id; }
-    const std::string &getLexeme() const { return lexeme; }
+    std::string_view getLexeme() const { return lexeme; }
     int getPosition() const { return position; }
 
+    // id do identificador no Interner do Lexico (-1 para os demais tokens)
+    int getSymbol() const { return symbol; }
+
 private:
     TokenId id;
-    std::string lexeme;
+    std::string_view lexeme;
     int position;
+    int symbol;
 };
 
 #endif
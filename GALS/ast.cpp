@@ -0,0 +1,441 @@
+#include "ast.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// =================== Arena ===================
+void* AstArena::allocate(std::size_t size, std::size_t align) {
+    std::size_t pad = reinterpret_cast<std::uintptr_t>(cur_) % align;
+    if (pad) pad = align - pad;
+
+    if (cur_ == nullptr || pad + size > left_) {
+        std::size_t n = size + align > kBlockSize ? size + align : kBlockSize;
+        blocks_.emplace_back(new char[n]);
+        cur_  = blocks_.back().get();
+        left_ = n;
+        pad   = reinterpret_cast<std::uintptr_t>(cur_) % align;
+        if (pad) pad = align - pad;
+    }
+
+    char* p = cur_ + pad;
+    cur_  += pad + size;
+    left_ -= pad + size;
+    return p;
+}
+
+std::string_view AstArena::copy(std::string_view s) {
+    if (s.empty()) return {};
+    char* p = static_cast<char*>(allocate(s.size(), 1));
+    std::memcpy(p, s.data(), s.size());
+    return std::string_view(p, s.size());
+}
+
+void AstArena::clear() {
+    blocks_.clear();
+    cur_  = nullptr;
+    left_ = 0;
+}
+
+// =================== helpers ===================
+static long parseIntLexeme(std::string_view t, int tok) {
+    std::string s(t);
+    if (tok == t_HEXADECIMAL)
+        return std::strtol(s.c_str(), nullptr, 16);          // aceita 0x/0X
+    if (tok == t_BINARIO) {
+        size_t i = (s.size() > 2 && (s[1] == 'b' || s[1] == 'B')) ? 2 : 0;
+        return std::strtol(s.c_str() + i, nullptr, 2);
+    }
+    return std::strtol(s.c_str(), nullptr, 10);
+}
+
+// =================== Construtor ===================
+void AstBuilder::reset() {
+    arena_.clear();
+    stack_.clear();
+    root_ = nullptr;
+}
+
+AstNode* AstBuilder::node(AstKind k, int pos) {
+    AstNode* n = arena_.make<AstNode>();
+    n->kind = k;
+    n->pos  = pos;
+    return n;
+}
+
+void AstBuilder::shift(const Token& tok) {
+    Slot s;
+    s.tok = tok.getId();
+    s.pos = tok.getPosition();
+    switch (s.tok) {
+    case t_ID:
+        s.sym = tok.getSymbol();
+        if (nomes_ && s.sym >= 0) {
+            s.text = nomes_->texto(s.sym);
+            break;
+        }
+        s.text = arena_.copy(tok.getLexeme());
+        break;
+    case t_LIT_INTEIRO:
+    case t_LIT_DECIMAIS:
+    case t_HEXADECIMAL:
+    case t_BINARIO:
+    case t_STRING:
+    case t_CHAR:
+        s.text = arena_.copy(tok.getLexeme());
+        break;
+    default:
+        break;
+    }
+    stack_.push_back(s);
+}
+
+void AstBuilder::action() {
+    stack_.push_back(Slot());
+}
+
+void AstBuilder::reduce(int production, int length) {
+    Slot* rhs = stack_.data() + stack_.size() - length;
+    Slot r = build(production, rhs, length);
+    stack_.resize(stack_.size() - length);
+    stack_.push_back(r);
+}
+
+void AstBuilder::accept() {
+    root_ = node(AstKind::Program, 0);
+    if (!stack_.empty())
+        root_->a = stack_.back().node;
+}
+
+// concatena duas listas (cabeça/cauda) em O(1)
+static void concat(AstNode*& head, AstNode*& tail, AstNode* h2, AstNode* t2) {
+    if (!h2) return;
+    if (!head) { head = h2; tail = t2; return; }
+    tail->next = h2;
+    tail = t2;
+}
+
+// define o tipo em todos os declaradores de uma lista
+static void setTipo(AstNode* list, int tipo) {
+    for (AstNode* n = list; n; n = n->next)
+        if (n->kind == AstKind::VarDecl) n->op = tipo;
+}
+
+// cabeça + cauda "op X op Y ..." -> árvore associativa à esquerda
+AstNode* AstBuilder::foldTail(AstNode* head, AstNode* tail) {
+    AstNode* acc = head;
+    while (tail) {
+        AstNode* nx = tail->next;
+        tail->next = nullptr;
+        tail->a = acc;
+        acc = tail;
+        tail = nx;
+    }
+    return acc;
+}
+
+// Produções numeradas conforme PRODUCTIONS em Constants.cpp (gerado pelo GALS).
+// Ações semânticas (#n) ocupam uma posição no lado direito.
+AstBuilder::Slot AstBuilder::build(int p, Slot* rhs, int length) {
+    Slot r;
+    if (length > 0) {
+        r.pos = rhs[0].pos;
+        r.tok = rhs[0].tok;
+    }
+
+    auto single = [&r](AstNode* n) { r.node = n; r.tail = n; };
+    auto pass   = [&r, rhs]() { r.node = rhs[0].node; r.tail = rhs[0].tail; };
+    auto tailOf = [](const Slot& s) { return s.tail ? s.tail : s.node; };
+    auto cat    = [&r, &tailOf](const Slot& x, const Slot& y) {
+        r.node = x.node; r.tail = tailOf(x);
+        concat(r.node, r.tail, y.node, tailOf(y));
+    };
+    auto prepend = [&r, &tailOf](AstNode* item, const Slot& rest) {
+        item->next = rest.node;
+        r.node = item;
+        r.tail = rest.node ? tailOf(rest) : item;
+    };
+    auto tailOp = [&](AstNode* operand, const Slot& rest) {
+        AstNode* n = node(AstKind::Binary, rhs[0].pos);
+        n->op   = rhs[0].tok;
+        n->b    = operand;
+        n->next = rest.node;
+        single(n);
+    };
+    auto declarator = [&](int id, AstNode* size, AstNode* init, AstNode* list, bool arr) {
+        AstNode* n = node(AstKind::VarDecl, rhs[id].pos);
+        n->name    = rhs[id].text;
+        n->sym     = rhs[id].sym;
+        n->isArray = arr;
+        n->a = size; n->b = init; n->c = list;
+        single(n);
+    };
+    auto incDec = [&](int opIdx, AstNode* target, bool prefix) {
+        AstNode* n = node(AstKind::IncDec, r.pos);
+        n->op = rhs[opIdx].tok;
+        n->prefix = prefix;
+        n->a = target;
+        single(n);
+    };
+    auto idNode = [&](int i) {
+        AstNode* n = node(AstKind::Id, rhs[i].pos);
+        n->name = rhs[i].text;
+        n->sym  = rhs[i].sym;
+        return n;
+    };
+    auto indexNode = [&](int i, AstNode* idx) {
+        AstNode* n = node(AstKind::Index, rhs[i].pos);
+        n->name = rhs[i].text;
+        n->sym  = rhs[i].sym;
+        n->a = idx;
+        return n;
+    };
+    auto stmt = [&](AstKind k) { return node(k, r.pos); };
+
+    switch (p) {
+    // programa / listas de itens
+    case 0: case 3: case 4: case 5:
+    case 6: case 7: case 8: case 9:
+        pass(); break;
+    case 1: case 2: case 58:
+        cat(rhs[0], rhs[1]); break;
+    case 10: case 11: case 66: case 67: {
+        AstNode* n = stmt(AstKind::ExprStmt);
+        n->a = rhs[0].node;
+        single(n);
+        break;
+    }
+
+    // chamada de função
+    case 12: case 13: {
+        AstNode* n = node(AstKind::Call, rhs[0].pos);
+        n->name = rhs[0].text;
+        n->sym  = rhs[0].sym;
+        n->a = (p == 12) ? rhs[4].node : nullptr;
+        single(n);
+        break;
+    }
+    case 14: case 37: case 46: case 53: case 83:
+        cat(rhs[0], rhs[2]); break;
+    case 15: case 16: case 21: case 38: case 47: case 54: case 59:
+    case 60: case 61: case 62: case 63: case 64: case 65:
+    case 77: case 78: case 81: case 84: case 95: case 138:
+    case 144: case 145: case 146:
+        pass(); break;
+    case 17:
+        single(indexNode(0, rhs[2].node)); break;
+
+    // declaração global: tipo ID <resto>
+    case 18: {
+        AstNode* n = rhs[4].node;
+        n->name = rhs[2].text;
+        n->sym  = rhs[2].sym;
+        n->pos  = rhs[2].pos;
+        if (n->kind == AstKind::Function) {
+            n->op = rhs[0].tok;
+            single(n);
+        } else {
+            setTipo(n, rhs[0].tok);
+            r.node = n;
+            r.tail = tailOf(rhs[4]);
+        }
+        break;
+    }
+    case 19: case 20: {
+        AstNode* n = node(AstKind::Function, rhs[2].pos);
+        n->name = rhs[2].text;
+        n->sym  = rhs[2].sym;
+        n->op   = t_KEY_VOID;
+        n->a    = (p == 19) ? rhs[6].node : nullptr;
+        n->b    = (p == 19) ? rhs[9].node : rhs[8].node;
+        single(n);
+        break;
+    }
+    case 22: case 23: {
+        AstNode* n = node(AstKind::Function, r.pos);
+        n->a = (p == 22) ? rhs[2].node : nullptr;
+        n->b = (p == 22) ? rhs[5].node : rhs[4].node;
+        single(n);
+        break;
+    }
+    case 24: case 25: case 26: case 27: {
+        AstNode* n = node(AstKind::VarDecl, r.pos);
+        n->isArray = (p >= 26);
+        n->a = n->isArray ? rhs[1].node : nullptr;
+        r.node = n; r.tail = n;
+        if (p == 25) { n->next = rhs[1].node; r.tail = tailOf(rhs[1]); }
+        if (p == 27) { n->next = rhs[4].node; r.tail = tailOf(rhs[4]); }
+        break;
+    }
+
+    // declarações locais
+    case 28: case 82:
+        setTipo(rhs[2].node, rhs[0].tok);
+        r.node = rhs[2].node; r.tail = tailOf(rhs[2]);
+        break;
+    case 29:
+        setTipo(rhs[2].node, rhs[0].tok);
+        cat(rhs[2], rhs[5]);
+        break;
+    case 30: case 31: case 32: case 33: case 34: case 35: case 36:
+        break;  // r.tok = token do tipo
+    case 39: case 40: {
+        AstNode* n = stmt(AstKind::Block);
+        n->a = (p == 40) ? rhs[1].node : nullptr;
+        single(n);
+        break;
+    }
+    case 41: case 48: declarator(0, nullptr, nullptr, nullptr, false); break;
+    case 42: case 49: declarator(0, nullptr, rhs[3].node, nullptr, false); break;
+    case 43: case 50: declarator(0, rhs[3].node, nullptr, nullptr, true); break;
+    case 44: case 51: declarator(0, rhs[3].node, nullptr, rhs[7].node, true); break;
+    case 45: case 52: declarator(0, nullptr, nullptr, rhs[6].node, true); break;
+    case 55: case 56: {
+        declarator(2, nullptr, nullptr, nullptr, p == 56);
+        r.node->op = rhs[0].tok;
+        r.node->isParam = true;
+        break;
+    }
+
+    // comandos
+    case 57: {
+        AstNode* n = stmt(AstKind::Block);
+        n->a = rhs[2].node;
+        single(n);
+        break;
+    }
+    case 68: case 76: {
+        AstNode* n = node(AstKind::Assign, r.pos);
+        n->a = rhs[0].node;
+        n->b = rhs[2].node;
+        single(n);
+        break;
+    }
+    case 69: case 143: single(idNode(0)); break;
+    case 70: case 156: single(indexNode(0, rhs[3].node)); break;
+    case 71: case 72: {
+        AstNode* n = stmt(AstKind::If);
+        n->a = rhs[2].node;
+        n->b = rhs[4].node;
+        n->c = (p == 72) ? rhs[6].node : nullptr;
+        single(n);
+        break;
+    }
+    case 73: {
+        AstNode* n = stmt(AstKind::While);
+        n->a = rhs[2].node;
+        n->b = rhs[4].node;
+        single(n);
+        break;
+    }
+    case 74: {
+        AstNode* n = stmt(AstKind::For);
+        n->a = rhs[2].node;
+        n->b = rhs[4].node;
+        n->c = rhs[6].node;
+        n->d = rhs[8].node;
+        single(n);
+        break;
+    }
+    case 75: {
+        AstNode* n = stmt(AstKind::DoWhile);
+        n->a = rhs[1].node;
+        n->b = rhs[4].node;
+        single(n);
+        break;
+    }
+    case 79: case 80: {
+        AstNode* n = stmt(AstKind::ExprStmt);
+        n->a = rhs[0].node;
+        single(n);
+        break;
+    }
+    case 88: case 89: {
+        AstNode* n = stmt(AstKind::Return);
+        n->a = (p == 89) ? rhs[1].node : nullptr;
+        single(n);
+        break;
+    }
+    case 90: case 91: {
+        AstNode* n = stmt(p == 90 ? AstKind::Cin : AstKind::Cout);
+        n->a = rhs[1].node;
+        single(n);
+        break;
+    }
+    case 92: case 93: case 158:
+        prepend(rhs[1].node, rhs[2]); break;
+    case 157:
+        single(rhs[1].node); break;
+
+    // expressões: cabeça + cauda
+    case 96: case 100: case 103: case 106: case 118: case 129: case 133:
+        single(foldTail(rhs[0].node, rhs[1].node)); break;
+    case 97: case 98: case 101: case 104: case 107:
+    case 119: case 120: case 130: case 131:
+    case 134: case 135: case 136:
+        tailOp(rhs[1].node, rhs[2]); break;
+    case 117:
+        if (rhs[1].node) {
+            rhs[1].node->a = rhs[0].node;
+            single(rhs[1].node);
+        } else {
+            pass();
+        }
+        break;
+    case 122: case 123: case 124: case 125: case 126: case 127:
+        tailOp(rhs[1].node, Slot()); break;
+
+    // ++ / --
+    case 109: case 110: incDec(1, idNode(0), false); break;
+    case 111: case 112: incDec(0, idNode(1), true); break;
+    case 113: case 114: incDec(1, rhs[0].node, false); break;
+    case 115: case 116: incDec(0, rhs[1].node, true); break;
+
+    // unários
+    case 139: case 140: case 141: case 142: {
+        AstNode* n = node(AstKind::Unary, r.pos);
+        n->op = rhs[0].tok;
+        n->a  = rhs[1].node;
+        single(n);
+        break;
+    }
+
+    // literais
+    case 147: case 153: case 154: {
+        AstNode* n = node(AstKind::IntLit, r.pos);
+        n->value = parseIntLexeme(rhs[0].text, rhs[0].tok);
+        n->name  = rhs[0].text;
+        single(n);
+        break;
+    }
+    case 150: {
+        // 'c' -> código do caractere (a BIP só trabalha com inteiros)
+        AstNode* n = node(AstKind::IntLit, r.pos);
+        std::string_view t = rhs[0].text;
+        n->value = t.size() >= 3 ? (unsigned char)t[1] : 0;
+        n->name  = t;
+        single(n);
+        break;
+    }
+    case 151: case 152: {
+        AstNode* n = node(AstKind::IntLit, r.pos);
+        n->value = (p == 151) ? 1 : 0;
+        single(n);
+        break;
+    }
+    case 148: case 149: {
+        AstNode* n = node(AstKind::OtherLit, r.pos);
+        n->op   = rhs[0].tok;
+        n->name = rhs[0].text;
+        single(n);
+        break;
+    }
+    case 155:
+        single(rhs[1].node); break;
+
+    default:   // produções vazias (caudas, listas) e inalcançáveis
+        break;
+    }
+    return r;
+}
@@ -0,0 +1,127 @@
+#ifndef AST_H
+#define AST_H
+
+#include "Constants.h"
+#include "Token.h"
+#include "interner.h"
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <vector>
+
+// =================== Arena ===================
+// Todos os nós da AST vivem em blocos grandes liberados de uma vez só.
+// Os nós são triviais (sem destrutor), então não é preciso percorrê-los.
+class AstArena {
+public:
+    AstArena() = default;
+    AstArena(const AstArena&) = delete;
+    AstArena& operator=(const AstArena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t align);
+
+    template <class T>
+    T* make() { return new (allocate(sizeof(T), alignof(T))) T(); }
+
+    // copia texto para dentro da arena (lexemas de IDs/literais)
+    std::string_view copy(std::string_view s);
+
+    void clear();
+
+private:
+    static constexpr std::size_t kBlockSize = 16 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    char*       cur_  = nullptr;
+    std::size_t left_ = 0;
+};
+
+// =================== Nós ===================
+enum class AstKind : unsigned char {
+    Program,    // a = lista de itens (funções, declarações, comandos)
+    Function,   // name, op = tipo de retorno, a = parâmetros, b = corpo
+    VarDecl,    // name, op = tipo, a = tamanho, b = inicializador, c = lista {...}
+    Block,      // a = lista de comandos
+    Assign,     // a = destino (Id/Index), b = expressão
+    If,         // a = condição, b = então, c = senão
+    While,      // a = condição, b = corpo
+    DoWhile,    // a = corpo, b = condição
+    For,        // a = init, b = condição, c = passo, d = corpo
+    Return,     // a = expressão (opcional)
+    Cin,        // a = lista de destinos
+    Cout,       // a = lista de expressões
+    ExprStmt,   // a = expressão
+    Call,       // name, a = argumentos
+    Id,         // name
+    Index,      // name, a = índice
+    IntLit,     // value
+    OtherLit,   // name = texto (float/string/char), op = token
+    Unary,      // op, a
+    Binary,     // op, a, b
+    IncDec      // op (++/--), prefix, a = destino
+};
+
+struct AstNode {
+    AstKind          kind     = AstKind::Program;
+    bool             isArray  = false;   // VarDecl
+    bool             isParam  = false;   // VarDecl
+    bool             prefix   = false;   // IncDec
+    int              op       = 0;       // TokenId do operador/tipo
+    int              pos      = -1;      // posição no fonte
+    long             value    = 0;       // IntLit
+    int              sym      = -1;      // id do nome no Interner (-1 = literal/sem nome)
+    std::string_view name;
+
+    AstNode* a = nullptr;
+    AstNode* b = nullptr;
+    AstNode* c = nullptr;
+    AstNode* d = nullptr;
+
+    AstNode* next = nullptr;             // irmão seguinte em listas
+};
+
+// =================== Construtor (ações de redução) ===================
+// Alimentado pelo Sintatico durante o único parse: cada SHIFT empilha o
+// token, cada ação semântica empilha um marcador vazio e cada REDUCE troca
+// os N valores do topo pelo nó da produção.
+class AstBuilder {
+public:
+    AstBuilder() = default;
+
+    // com o Interner do Lexico, os nomes apontam para o texto internado
+    // em vez de serem copiados para a arena (o Lexico deve viver mais)
+    void setInterner(const Interner* nomes) { nomes_ = nomes; }
+
+    void reset();
+
+    void shift(const Token& tok);
+    void action();
+    void reduce(int production, int length);
+    void accept();
+
+    const AstNode* root() const { return root_; }
+
+private:
+    struct Slot {
+        AstNode*         node = nullptr;   // valor (ou cabeça de lista)
+        AstNode*         tail = nullptr;   // cauda da lista, para concatenar em O(1)
+        int              tok  = 0;
+        int              pos  = -1;
+        int              sym  = -1;
+        std::string_view text;
+    };
+
+    AstNode* node(AstKind k, int pos);
+    Slot     build(int production, Slot* rhs, int length);
+
+    static AstNode* foldTail(AstNode* head, AstNode* tail);
+
+    AstArena          arena_;
+    std::vector<Slot> stack_;
+    AstNode*          root_ = nullptr;
+    const Interner*   nomes_ = nullptr;
+};
+
+#endif // AST_H
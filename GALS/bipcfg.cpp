@@ -0,0 +1,415 @@
+#include "bipcfg.h"
+
+#include <unordered_map>
+#include <unordered_set>
+
+// =================== BitSet ===================
+bool BitSet::unite(const BitSet& o) {
+    bool mudou = false;
+    for (std::size_t k = 0; k < w_.size(); ++k) {
+        const uint64_t novo = w_[k] | o.w_[k];
+        mudou |= novo != w_[k];
+        w_[k] = novo;
+    }
+    return mudou;
+}
+
+void BitSet::subtract(const BitSet& o) {
+    for (std::size_t k = 0; k < w_.size(); ++k)
+        w_[k] &= ~o.w_[k];
+}
+
+int BitSet::count() const {
+    int n = 0;
+    forEach([&](int) { ++n; });
+    return n;
+}
+
+// =================== Uso/definição ===================
+BipAccess bipAccess(const BipInstr& in, const BipVars& v) {
+    BipAccess a;
+    const int dado = in.kind == BipOperand::Sym ? static_cast<int>(in.arg) : -1;
+    auto use = [&](int x) { a.use[a.nUse++] = x; };
+    auto def = [&](int x) { a.def[a.nDef++] = x; };
+
+    switch (in.op) {
+    case BipOp::LD:
+        use(dado);
+        def(v.acc());
+        a.sideEffect = dado == v.inPort;
+        break;
+    case BipOp::LDI:
+        def(v.acc());
+        break;
+    case BipOp::STO:
+        use(v.acc());
+        def(dado);
+        a.sideEffect = dado == v.outPort;
+        break;
+    case BipOp::LDV:
+        use(dado);
+        use(v.indr);
+        def(v.acc());
+        break;
+    case BipOp::STOV:
+        use(v.acc());
+        use(v.indr);
+        def(dado);
+        a.partialDef = true;
+        break;
+
+    case BipOp::JZ:
+    case BipOp::RETURN:                  // valor de retorno no ACC
+        use(v.acc());
+        break;
+    case BipOp::BEQ: case BipOp::BNE:
+    case BipOp::BGT: case BipOp::BGE:
+    case BipOp::BLT: case BipOp::BLE:
+        use(v.status());
+        break;
+    case BipOp::JMP: case BipOp::CALL:   // efeito da função vem pelo CFG
+    case BipOp::HLT: case BipOp::Label:
+        break;
+
+    case BipOp::Raw:
+        a.useAll = true;
+        a.sideEffect = true;
+        break;
+
+    default:                             // ULA: ACC op [operando]
+        use(v.acc());
+        if (dado >= 0) use(dado);
+        def(v.acc());
+        def(v.status());
+        break;
+    }
+    return a;
+}
+
+// =================== CFG ===================
+static bool endsBlock(BipOp op) {
+    return bipIsJump(op) || op == BipOp::RETURN || op == BipOp::HLT;
+}
+
+BipCfg::BipCfg(const std::vector<BipInstr>& code) : code_(code) {
+    const int n = static_cast<int>(code.size());
+    blockOf_.assign(n, -1);
+
+    // líderes: início, rótulos e a instrução após um desvio
+    for (int i = 0; i < n; ) {
+        BipBlock b;
+        b.begin = i;
+        do {
+            ++i;
+        } while (i < n && code[i].op != BipOp::Label && !endsBlock(code[i - 1].op));
+        b.end = i;
+        for (int k = b.begin; k < b.end; ++k)
+            blockOf_[k] = static_cast<int>(blocks_.size());
+        blocks_.push_back(std::move(b));
+    }
+
+    std::unordered_map<long, int> blocoDoRotulo;
+    for (const BipBlock& b : blocks_)
+        if (code[b.begin].op == BipOp::Label)
+            blocoDoRotulo.emplace(code[b.begin].arg, blockOf_[b.begin]);
+    auto alvo = [&](const BipInstr& in) {
+        auto it = blocoDoRotulo.find(in.arg);
+        return it == blocoDoRotulo.end() ? -1 : it->second;
+    };
+
+    struct Chamada { int bloco, entrada; };
+    std::vector<Chamada> chamadas;
+
+    const int nb = static_cast<int>(blocks_.size());
+    for (int b = 0; b < nb; ++b) {
+        BipBlock& blk = blocks_[b];
+        const BipInstr& fim = code[blk.end - 1];
+        const int seguinte = b + 1 < nb ? b + 1 : -1;
+        const int destino = fim.kind == BipOperand::Label ? alvo(fim) : -1;
+
+        switch (fim.op) {
+        case BipOp::JMP:
+            if (destino >= 0) blk.succ.push_back({ destino, BipEdgeKind::Jump });
+            break;
+        case BipOp::JZ:  case BipOp::BEQ: case BipOp::BNE:
+        case BipOp::BGT: case BipOp::BGE: case BipOp::BLT: case BipOp::BLE:
+            if (destino >= 0) blk.succ.push_back({ destino, BipEdgeKind::Branch });
+            if (seguinte >= 0) blk.succ.push_back({ seguinte, BipEdgeKind::Fall });
+            break;
+        case BipOp::CALL:
+            if (destino >= 0) {
+                blk.succ.push_back({ destino, BipEdgeKind::Call });
+                chamadas.push_back({ b, destino });
+            } else if (seguinte >= 0) {
+                blk.succ.push_back({ seguinte, BipEdgeKind::Fall });
+            }
+            break;
+        case BipOp::RETURN:
+        case BipOp::HLT:
+            break;
+        default:
+            if (seguinte >= 0) blk.succ.push_back({ seguinte, BipEdgeKind::Fall });
+            break;
+        }
+    }
+
+    // função dona de cada bloco: alcançável da entrada sem entrar em CALL
+    // (o retorno de um CALL continua na mesma função). As funções chamadas
+    // vêm antes do bloco 0, que chega a MAIN por JMP: main() chamada
+    // recursivamente precisa ser dona dos próprios RETURNs.
+    std::vector<int> entradas;
+    for (const Chamada& c : chamadas)
+        entradas.push_back(c.entrada);
+    entradas.push_back(0);
+    std::vector<int> pilha;
+    for (int e : entradas) {
+        if (nb == 0 || blocks_[e].function >= 0) continue;
+        blocks_[e].function = e;
+        pilha.push_back(e);
+        while (!pilha.empty()) {
+            const int b = pilha.back();
+            pilha.pop_back();
+            auto visita = [&](int s) {
+                if (s >= 0 && blocks_[s].function < 0) {
+                    blocks_[s].function = e;
+                    pilha.push_back(s);
+                }
+            };
+            for (const BipEdge& ed : blocks_[b].succ)
+                if (ed.kind != BipEdgeKind::Call) visita(ed.to);
+            if (code[blocks_[b].end - 1].op == BipOp::CALL && b + 1 < nb)
+                visita(b + 1);
+        }
+    }
+
+    // RETURN volta para depois de cada CALL da função
+    for (BipBlock& blk : blocks_) {
+        if (code[blk.end - 1].op != BipOp::RETURN || blk.function < 0) continue;
+        for (const Chamada& c : chamadas)
+            if (c.entrada == blk.function && c.bloco + 1 < nb)
+                blk.succ.push_back({ c.bloco + 1, BipEdgeKind::Return });
+    }
+
+    for (int b = 0; b < nb; ++b)
+        for (const BipEdge& ed : blocks_[b].succ)
+            blocks_[ed.to].pred.push_back(b);
+}
+
+bool bipCfgComplete(const std::vector<BipInstr>& code) {
+    std::unordered_set<long> rotulos;
+    for (const BipInstr& in : code) {
+        if (in.op == BipOp::Raw) return false;
+        if (in.op == BipOp::Label) rotulos.insert(in.arg);
+    }
+    for (const BipInstr& in : code)
+        if (in.op != BipOp::Label && in.kind == BipOperand::Label && !rotulos.count(in.arg))
+            return false;
+    return true;
+}
+
+static void escapeDot(const std::string& s, std::string& out) {
+    for (char c : s) {
+        if (c == '\n') { out += "\\l"; continue; }
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+}
+
+std::string BipCfg::toDot(const std::function<void(const BipInstr&, std::string&)>& render,
+                          const std::function<std::string(int bloco)>& note) const {
+    std::string out = "digraph cfg {\n    node [shape=box, fontname=\"monospace\"];\n";
+    std::string linha;
+
+    for (std::size_t b = 0; b < blocks_.size(); ++b) {
+        const BipBlock& blk = blocks_[b];
+        out += "    B" + std::to_string(b) + " [label=\"B" + std::to_string(b);
+        if (blk.function >= 0 && blk.function != static_cast<int>(b))
+            out += " (em B" + std::to_string(blk.function) + ")";
+        out += "\\l";
+        for (int i = blk.begin; i < blk.end; ++i) {
+            linha.assign(code_[i].op == BipOp::Label ? "" : "    ");
+            render(code_[i], linha);
+            escapeDot(linha, out);
+            out += "\\l";
+        }
+        if (note) {
+            escapeDot(note(static_cast<int>(b)), out);
+            out += "\\l";
+        }
+        out += "\"];\n";
+    }
+
+    for (std::size_t b = 0; b < blocks_.size(); ++b) {
+        for (const BipEdge& ed : blocks_[b].succ) {
+            out += "    B" + std::to_string(b) + " -> B" + std::to_string(ed.to);
+            switch (ed.kind) {
+            case BipEdgeKind::Jump:   out += " [color=blue]"; break;
+            case BipEdgeKind::Branch: out += " [color=darkgreen, label=\"T\"]"; break;
+            case BipEdgeKind::Call:   out += " [style=dashed, label=\"call\"]"; break;
+            case BipEdgeKind::Return: out += " [style=dotted, label=\"ret\"]"; break;
+            case BipEdgeKind::Fall:   break;
+            }
+            out += ";\n";
+        }
+    }
+    out += "}\n";
+    return out;
+}
+
+// =================== Solver ===================
+// Problemas "may" com união no encontro. Para trás o encontro junta os
+// sucessores em 'out' e a transferência produz 'in'; para frente, o inverso.
+template <class Transfer>
+static int solveDataflow(const BipCfg& cfg, bool paraTras, int universo,
+                         std::vector<BitSet>& in, std::vector<BitSet>& out,
+                         Transfer transfer) {
+    const auto& blocks = cfg.blocks();
+    const int nb = static_cast<int>(blocks.size());
+    in.assign(nb, BitSet(universo));
+    out.assign(nb, BitSet(universo));
+
+    std::vector<int>  lista;
+    std::vector<char> naLista(nb, 1);
+    lista.reserve(nb);
+    // a pilha processa o fim primeiro: para trás começa pelo último bloco
+    for (int b = 0; b < nb; ++b)
+        lista.push_back(paraTras ? b : nb - 1 - b);
+
+    int iteracoes = 0;
+    BitSet encontro(universo), resultado(universo);
+    while (!lista.empty()) {
+        const int b = lista.back();
+        lista.pop_back();
+        naLista[b] = 0;
+        ++iteracoes;
+
+        encontro.clear();
+        if (paraTras) {
+            for (const BipEdge& e : blocks[b].succ) encontro.unite(in[e.to]);
+        } else {
+            for (int p : blocks[b].pred) encontro.unite(out[p]);
+        }
+        transfer(b, encontro, resultado);
+
+        BitSet& meet = paraTras ? out[b] : in[b];
+        BitSet& res  = paraTras ? in[b]  : out[b];
+        meet = encontro;
+        if (resultado == res) continue;
+        res = resultado;
+
+        auto agenda = [&](int x) {
+            if (!naLista[x]) { naLista[x] = 1; lista.push_back(x); }
+        };
+        if (paraTras) { for (int p : blocks[b].pred) agenda(p); }
+        else          { for (const BipEdge& e : blocks[b].succ) agenda(e.to); }
+    }
+    return iteracoes;
+}
+
+// =================== Liveness ===================
+void bipLiveStep(const BipAccess& a, const BipVars& v, BitSet& vivas) {
+    if (!a.partialDef)
+        for (int k = 0; k < a.nDef; ++k) vivas.reset(a.def[k]);
+    for (int k = 0; k < a.nUse; ++k) vivas.set(a.use[k]);
+    if (a.useAll)
+        for (int x = 0; x < v.count(); ++x) vivas.set(x);
+}
+
+BipLiveness::BipLiveness(const BipCfg& cfg, const BipVars& vars)
+    : cfg_(cfg), vars_(vars) {
+    const auto& code = cfg.code();
+    const int nb = static_cast<int>(cfg.blocks().size());
+    const int nv = vars.count();
+
+    // in = gen ∪ (out − kill)
+    std::vector<BitSet> gen(nb, BitSet(nv)), kill(nb, BitSet(nv));
+    for (int b = 0; b < nb; ++b) {
+        const BipBlock& blk = cfg.blocks()[b];
+        for (int i = blk.end - 1; i >= blk.begin; --i) {
+            const BipAccess a = bipAccess(code[i], vars);
+            bipLiveStep(a, vars, gen[b]);
+            if (!a.partialDef)
+                for (int k = 0; k < a.nDef; ++k) kill[b].set(a.def[k]);
+        }
+    }
+
+    iterations_ = solveDataflow(cfg, true, nv, in_, out_,
+        [&](int b, const BitSet& out, BitSet& in) {
+            in = out;
+            in.subtract(kill[b]);
+            in.unite(gen[b]);
+        });
+}
+
+std::vector<BitSet> BipLiveness::liveAfter(int b) const {
+    const BipBlock& blk = cfg_.blocks()[b];
+    std::vector<BitSet> r(blk.end - blk.begin);
+    BitSet vivas = out_[b];
+    for (int i = blk.end - 1; i >= blk.begin; --i) {
+        r[i - blk.begin] = vivas;
+        bipLiveStep(bipAccess(cfg_.code()[i], vars_), vars_, vivas);
+    }
+    return r;
+}
+
+// =================== Definições que alcançam ===================
+BipReachingDefs::BipReachingDefs(const BipCfg& cfg, const BipVars& vars) {
+    const auto& code = cfg.code();
+    const int n  = static_cast<int>(code.size());
+    const int nb = static_cast<int>(cfg.blocks().size());
+
+    // só memória: STO x (mata as outras de x) e STOV v (não mata)
+    std::vector<int>  defDe(n, -1);            // instrução -> número da definição
+    std::vector<int>  varDe;                   // definição -> variável
+    std::vector<char> parcial;
+    defsOf_.assign(vars.data, {});
+    for (int i = 0; i < n; ++i) {
+        const BipInstr& in = code[i];
+        if ((in.op == BipOp::STO || in.op == BipOp::STOV) && in.kind == BipOperand::Sym &&
+            in.arg >= 0 && in.arg < vars.data) {
+            defDe[i] = static_cast<int>(instr_.size());
+            instr_.push_back(i);
+            varDe.push_back(static_cast<int>(in.arg));
+            parcial.push_back(in.op == BipOp::STOV);
+            defsOf_[in.arg].push_back(defDe[i]);
+        }
+    }
+    const int nd = static_cast<int>(instr_.size());
+
+    // por bloco: definições geradas (a última de cada variável) e as
+    // variáveis mortas por completo; o kill fica implícito em varDe
+    std::vector<BitSet>           gen(nb, BitSet(nd));
+    std::vector<std::vector<int>> mortas(nb);
+    std::vector<std::vector<int>> noBloco(vars.data);   // defs de x já vistas no bloco
+    for (int b = 0; b < nb; ++b) {
+        const BipBlock& blk = cfg.blocks()[b];
+        for (int i = blk.begin; i < blk.end; ++i) {
+            const int d = defDe[i];
+            if (d < 0) continue;
+            const int x = varDe[d];
+            if (!parcial[d]) {
+                for (int j : noBloco[x]) gen[b].reset(j);
+                noBloco[x].clear();
+                mortas[b].push_back(x);
+            }
+            gen[b].set(d);
+            noBloco[x].push_back(d);
+        }
+        for (int i = blk.begin; i < blk.end; ++i)
+            if (defDe[i] >= 0) noBloco[varDe[defDe[i]]].clear();
+    }
+
+    std::vector<char> morta(vars.data, 0);
+    iterations_ = solveDataflow(cfg, false, nd, in_, out_,
+        [&](int b, const BitSet& in, BitSet& out) {
+            out = gen[b];
+            if (mortas[b].empty()) {            // caso comum: só desvios/rótulos/cargas
+                out.unite(in);
+                return;
+            }
+            for (int x : mortas[b]) morta[x] = 1;
+            in.forEach([&](int d) { if (!morta[varDe[d]]) out.set(d); });
+            for (int x : mortas[b]) morta[x] = 0;
+        });
+}
@@ -0,0 +1,178 @@
+#ifndef BIPCFG_H
+#define BIPCFG_H
+
+#include "bipir.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include <string>
+#include <vector>
+
+// índice do bit 1 mais baixo (w != 0)
+inline int bitScan64(uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return static_cast<int>(i);
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+// =================== BitSet ===================
+// Conjunto denso de inteiros [0, size) para as análises de fluxo de dados.
+class BitSet {
+public:
+    BitSet() = default;
+    explicit BitSet(int n) : n_(n), w_((n + 63) / 64, 0) {}
+
+    int  size() const { return n_; }
+    void set(int i)        { w_[i >> 6] |=  (uint64_t(1) << (i & 63)); }
+    void reset(int i)      { w_[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+    bool test(int i) const { return (w_[i >> 6] >> (i & 63)) & 1; }
+
+    bool unite(const BitSet& o);          // this |= o; true se mudou
+    void subtract(const BitSet& o);       // this -= o
+    void clear() { std::fill(w_.begin(), w_.end(), 0); }
+    int  count() const;
+    bool operator==(const BitSet& o) const { return w_ == o.w_; }
+    bool operator!=(const BitSet& o) const { return w_ != o.w_; }
+
+    template <class F>
+    void forEach(F f) const {
+        for (std::size_t k = 0; k < w_.size(); ++k)
+            for (uint64_t w = w_[k]; w; w &= w - 1)
+                f(static_cast<int>(k * 64) + bitScan64(w));
+    }
+
+private:
+    int                   n_ = 0;
+    std::vector<uint64_t> w_;
+};
+
+// =================== Variáveis das análises ===================
+// Ids de dado do gerador (0 .. data-1) mais dois pseudo-registradores:
+// o ACC e o STATUS (escrito pela ULA, lido por BEQ/BNE/BGT/...).
+struct BipVars {
+    int data    = 0;     // quantidade de ids de dado
+    int indr    = -1;
+    int inPort  = -1;
+    int outPort = -1;
+
+    int acc()    const { return data; }
+    int status() const { return data + 1; }
+    int count()  const { return data + 2; }
+};
+
+// O que uma instrução lê e escreve
+struct BipAccess {
+    int  use[3];
+    int  nUse = 0;
+    int  def[2];
+    int  nDef = 0;
+    bool partialDef = false;   // STOV: escreve um elemento, não mata o vetor
+    bool useAll     = false;   // linha crua/CALL desconhecido: lê tudo
+    bool sideEffect = false;   // E/S: nunca é código morto
+};
+
+BipAccess bipAccess(const BipInstr& in, const BipVars& v);
+
+// vivas antes da instrução, a partir das vivas depois dela
+void bipLiveStep(const BipAccess& a, const BipVars& v, BitSet& vivas);
+
+// =================== CFG ===================
+enum class BipEdgeKind : unsigned char {
+    Fall,       // segue para o bloco seguinte
+    Jump,       // JMP
+    Branch,     // JZ, BEQ, BNE, ... tomado
+    Call,       // CALL -> entrada da função
+    Return      // RETURN -> instrução após cada CALL da função
+};
+
+struct BipEdge {
+    int         to;
+    BipEdgeKind kind;
+};
+
+struct BipBlock {
+    int begin = 0, end = 0;          // instruções [begin, end) de code
+    int function = -1;               // bloco de entrada da função dona
+    std::vector<BipEdge> succ;
+    std::vector<int>     pred;
+};
+
+// Grafo interprocedural: CALL liga à entrada da função e cada RETURN volta
+// para todos os pontos de chamada dela. O bloco 0 é a entrada do programa;
+// blocos sem sucessores (HLT, RETURN do programa, fim do código) são saídas.
+// Guarda referência para 'code': reconstruir depois de alterar a IR.
+class BipCfg {
+public:
+    explicit BipCfg(const std::vector<BipInstr>& code);
+
+    const std::vector<BipInstr>& code()   const { return code_; }
+    const std::vector<BipBlock>& blocks() const { return blocks_; }
+    int blockOf(int instr) const { return blockOf_[instr]; }
+
+    // Graphviz; 'render' escreve uma instrução, 'note' (opcional) acrescenta
+    // linhas ao fim de cada bloco (ex.: conjuntos da liveness)
+    std::string toDot(const std::function<void(const BipInstr&, std::string&)>& render,
+                      const std::function<std::string(int bloco)>& note = nullptr) const;
+
+private:
+    const std::vector<BipInstr>& code_;
+    std::vector<BipBlock>        blocks_;
+    std::vector<int>             blockOf_;
+};
+
+// O CFG só descreve o programa todo se não houver linha crua (Raw) nem
+// desvio para rótulo fora de 'code'; as passadas que removem ou renomeiam
+// instruções exigem isso
+bool bipCfgComplete(const std::vector<BipInstr>& code);
+
+// =================== Análises ===================
+// Ambas resolvidas pelo mesmo solver de worklist (união nos encontros).
+
+// Variáveis vivas na entrada/saída de cada bloco (para trás)
+class BipLiveness {
+public:
+    BipLiveness(const BipCfg& cfg, const BipVars& vars);
+
+    const BitSet& liveIn(int b)  const { return in_[b]; }
+    const BitSet& liveOut(int b) const { return out_[b]; }
+    int iterations() const { return iterations_; }
+
+    // vivas logo após cada instrução do bloco b (índice relativo a begin)
+    std::vector<BitSet> liveAfter(int b) const;
+
+private:
+    const BipCfg&       cfg_;
+    BipVars             vars_;
+    std::vector<BitSet> in_, out_;
+    int                 iterations_ = 0;
+};
+
+// Definições de memória (STO/STOV) que alcançam cada bloco. Os conjuntos
+// são de números de definição (0 .. defCount-1), não de instruções.
+class BipReachingDefs {
+public:
+    BipReachingDefs(const BipCfg& cfg, const BipVars& vars);
+
+    const BitSet& in(int b)  const { return in_[b]; }
+    const BitSet& out(int b) const { return out_[b]; }
+    int defCount() const { return static_cast<int>(instr_.size()); }
+    int instrOf(int def) const { return instr_[def]; }
+    const std::vector<int>& defsOf(int var) const { return defsOf_[var]; }
+    int iterations() const { return iterations_; }
+
+private:
+    std::vector<int>              instr_;    // definição -> índice em code
+    std::vector<std::vector<int>> defsOf_;   // variável -> definições
+    std::vector<BitSet>           in_, out_;
+    int                           iterations_ = 0;
+};
+
+#endif // BIPCFG_H
@@ -0,0 +1,41 @@
+#include "bipir.h"
+
+static const char* const kMnemonics[] = {
+    "LD", "LDI", "STO", "LDV", "STOV",
+    "ADD", "ADDI", "SUB", "SUBI", "MUL", "MULI", "DIV", "DIVI", "MOD", "MODI",
+    "AND", "ANDI", "OR", "ORI", "XOR", "XORI", "NOT",
+    "SLL", "SRL", "SHL", "SHR",
+    "JMP", "JZ", "BEQ", "BNE", "BGT", "BGE", "BLT", "BLE",
+    "CALL", "RETURN", "HLT",
+    "", ""
+};
+
+static_assert(sizeof(kMnemonics) / sizeof(kMnemonics[0]) == static_cast<int>(BipOp::Raw) + 1,
+              "kMnemonics deve acompanhar BipOp");
+
+const char* bipMnemonic(BipOp op) {
+    return kMnemonics[static_cast<int>(op)];
+}
+
+bool bipParseMnemonic(std::string_view s, BipOp& op) {
+    for (int i = 0; i < static_cast<int>(BipOp::Label); ++i) {
+        if (s == kMnemonics[i]) {
+            op = static_cast<BipOp>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool bipIsJump(BipOp op) {
+    switch (op) {
+    case BipOp::JMP: case BipOp::JZ:
+    case BipOp::BEQ: case BipOp::BNE:
+    case BipOp::BGT: case BipOp::BGE:
+    case BipOp::BLT: case BipOp::BLE:
+    case BipOp::CALL:
+        return true;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef BIPIR_H
+#define BIPIR_H
+
+#include <string_view>
+
+// =================== IR da BIP ===================
+// O gerador emite instruções neste formato compacto; o texto assembly só é
+// montado no fim (CodeGeneratorBIP::buildTextSection). Operandos de memória
+// e rótulos são ids nas tabelas do gerador, não strings.
+enum class BipOp : unsigned char {
+    // ACC <-> memória
+    LD, LDI, STO, LDV, STOV,
+    // aritmética/lógica (forma direta e imediata)
+    ADD, ADDI, SUB, SUBI, MUL, MULI, DIV, DIVI, MOD, MODI,
+    AND, ANDI, OR, ORI, XOR, XORI, NOT,
+    SLL, SRL, SHL, SHR,
+    // desvios
+    JMP, JZ, BEQ, BNE, BGT, BGE, BLT, BLE,
+    CALL, RETURN, HLT,
+    // pseudo-instruções
+    Label,      // "nome:" (operando = rótulo)
+    Raw         // linha crua passada a emitInstr (operando = índice do texto)
+};
+
+enum class BipOperand : unsigned char {
+    None,
+    Imm,        // valor imediato
+    Sym,        // id de dado/variável (nome na .data, $indr, portas)
+    Label,      // id de rótulo de código
+    Text        // índice de linha crua
+};
+
+struct BipInstr {
+    BipOp      op   = BipOp::Raw;
+    BipOperand kind = BipOperand::None;
+    long       arg  = 0;   // imediato, ou id conforme 'kind'
+    int        pos  = -1;  // posição no fonte do comando que a gerou (-1 = nenhum)
+};
+
+const char* bipMnemonic(BipOp op);
+bool        bipParseMnemonic(std::string_view s, BipOp& op);
+
+// desvios/chamadas: o operando é um rótulo de código
+bool bipIsJump(BipOp op);
+
+#endif // BIPIR_H
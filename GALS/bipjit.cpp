@@ -0,0 +1,458 @@
+#include "bipjit.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) && defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define BIPJIT_X86_64
+#endif
+
+bool BipVm::jitDisponivel() {
+#if defined(BIPJIT_X86_64)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// o JIT só roda blocos inteiros; o resto (E/S, paradas, fim do orçamento)
+// é uma instrução do interpretador, depois volta para o código gerado
+ResultadoExecucao BipVm::runJit(const std::vector<int>& entrada, const Limites& lim) const {
+    ResultadoExecucao r;
+    Estado e;
+    e.mem = img_.dados;
+    e.pc  = img_.entrada;
+    e.pilha.resize(std::max(lim.pilha, 0));
+
+    const int n = static_cast<int>(img_.codigo.size());
+    const uint64_t semLimite = uint64_t(INT64_MAX) / 2;
+    BipJitCodigo::Contexto c;
+    c.maxPilha = lim.pilha;
+    while (e.rodando) {
+        if (e.pc >= 0 && e.pc < n) {
+            const uint64_t resta = lim.instrucoes ? std::min(lim.instrucoes - r.instrucoes, semLimite) : semLimite;
+            c.mem    = e.mem.data();
+            c.pilha  = e.pilha.data();
+            c.prof   = e.prof;
+            c.orc    = static_cast<int64_t>(resta);
+            c.extra  = 0;
+            c.pc     = e.pc;
+            c.acc    = e.acc;
+            c.status = e.status;
+            c.indr   = e.indr;
+            jit_->executa(c);
+            const uint64_t feitas = resta - static_cast<uint64_t>(c.orc);
+            r.instrucoes += feitas;
+            r.ciclos     += feitas + c.extra;
+            e.prof   = static_cast<int>(c.prof);
+            e.pc     = c.pc;
+            e.acc    = static_cast<int16_t>(c.acc);
+            e.status = static_cast<int16_t>(c.status);
+            e.indr   = static_cast<int16_t>(c.indr);
+        }
+        interpreta(e, r, entrada, lim, 1);
+    }
+    r.acc = e.acc;
+    r.pc  = e.pc;
+    return r;
+}
+
+#if defined(BIPJIT_X86_64)
+
+namespace {
+
+enum Reg { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+// registradores fixos (todos preservados pela ABI do System V)
+constexpr int ACC = R12, STATUS = R13, INDR = R14, MEM = R15, ORC = RBP, CTX = RBX;
+
+enum Cond { CC_AE = 0x3, CC_E = 0x4, CC_NE = 0x5, CC_A = 0x7, CC_L = 0xC, CC_GE = 0xD, CC_LE = 0xE, CC_G = 0xF };
+
+// codificação das poucas instruções x86-64 que o JIT usa; 'disp' sempre de 32 bits
+class Emissor {
+public:
+    std::vector<uint8_t> b;
+
+    std::size_t pos() const { return b.size(); }
+    void u8(int v)       { b.push_back(static_cast<uint8_t>(v)); }
+    void u32(uint32_t v) { for (int k = 0; k < 4; ++k) u8(v >> (8 * k)); }
+    void patch32(std::size_t p, int32_t v) {
+        for (int k = 0; k < 4; ++k) b[p + k] = static_cast<uint8_t>(static_cast<uint32_t>(v) >> (8 * k));
+    }
+
+    void rex(bool w, int reg, int idx, int base) {
+        const int r = 0x40 | (w ? 8 : 0) | ((reg & 8) >> 1) | ((idx & 8) >> 2) | ((base & 8) >> 3);
+        if (r != 0x40) u8(r);
+    }
+    void rr(int reg, int rm) { u8(0xC0 | ((reg & 7) << 3) | (rm & 7)); }
+    void mem(int reg, int base, int32_t disp) {                 // [base + disp]
+        u8(0x80 | ((reg & 7) << 3) | (base & 7));
+        if ((base & 7) == RSP) u8(0x24);
+        u32(disp);
+    }
+    void memIdx(int reg, int base, int idx, int32_t disp) {     // [base + idx*2 + disp]
+        u8(0x84 | ((reg & 7) << 3));
+        u8(0x40 | ((idx & 7) << 3) | (base & 7));
+        u32(disp);
+    }
+
+    // op r/m, reg (ADD 01, OR 09, AND 21, SUB 29, XOR 31, CMP 39, TEST 85, MOV 89)
+    void opRR(int op, int dst, int src, bool w = false) { rex(w, src, 0, dst); u8(op); rr(src, dst); }
+    void movRR(int dst, int src) { opRR(0x89, dst, src); }
+    // grupo 81: ADD 0, OR 1, AND 4, SUB 5, XOR 6, CMP 7
+    void opRI(int ext, int dst, int32_t imm, bool w = false) { rex(w, 0, 0, dst); u8(0x81); rr(ext, dst); u32(imm); }
+    void movRI(int dst, int32_t imm) { rex(false, 0, 0, dst); u8(0xB8 + (dst & 7)); u32(imm); }
+    void movsxRR(int dst, int src) { rex(false, dst, 0, src); u8(0x0F); u8(0xBF); rr(dst, src); }
+    void movzxRR(int dst, int src) { rex(false, dst, 0, src); u8(0x0F); u8(0xB7); rr(dst, src); }
+    void movsxRM(int dst, int base, int32_t disp) { rex(false, dst, 0, base); u8(0x0F); u8(0xBF); mem(dst, base, disp); }
+    void movsxRMIdx(int dst, int base, int idx, int32_t disp) {
+        rex(false, dst, idx, base); u8(0x0F); u8(0xBF); memIdx(dst, base, idx, disp);
+    }
+    void sto16(int base, int32_t disp, int src) { u8(0x66); rex(false, src, 0, base); u8(0x89); mem(src, base, disp); }
+    void sto16Idx(int base, int idx, int32_t disp, int src) {
+        u8(0x66); rex(false, src, idx, base); u8(0x89); memIdx(src, base, idx, disp);
+    }
+    void imulRR(int dst, int src) { rex(false, dst, 0, src); u8(0x0F); u8(0xAF); rr(dst, src); }
+    void imulRRI(int dst, int src, int32_t imm) { rex(false, dst, 0, src); u8(0x69); rr(dst, src); u32(imm); }
+    void grupoF7(int ext, int r) { rex(false, 0, 0, r); u8(0xF7); rr(ext, r); }     // NOT 2, IDIV 7
+    void cdq() { u8(0x99); }
+    void shiftCl(int ext, int r) { rex(false, 0, 0, r); u8(0xD3); rr(ext, r); }      // SHL 4, SHR 5
+    void shiftI(int ext, int r, int k) { rex(false, 0, 0, r); u8(0xC1); rr(ext, r); u8(k); }
+    void cmov(int cc, int dst, int src) { rex(false, dst, 0, src); u8(0x0F); u8(0x40 + cc); rr(dst, src); }
+
+    void ld64(int dst, int base, int32_t disp) { rex(true, dst, 0, base); u8(0x8B); mem(dst, base, disp); }
+    void st64(int base, int32_t disp, int src) { rex(true, src, 0, base); u8(0x89); mem(src, base, disp); }
+    void ld32(int dst, int base, int32_t disp) { rex(false, dst, 0, base); u8(0x8B); mem(dst, base, disp); }
+    void st32(int base, int32_t disp, int src) { rex(false, src, 0, base); u8(0x89); mem(src, base, disp); }
+    void movsxd(int dst, int base, int32_t disp) { rex(true, dst, 0, base); u8(0x63); mem(dst, base, disp); }
+    void cmp64RM(int reg, int base, int32_t disp) { rex(true, reg, 0, base); u8(0x3B); mem(reg, base, disp); }
+    void inc64M(int base, int32_t disp) { rex(true, 0, 0, base); u8(0xFF); mem(0, base, disp); }
+    void mov32MI(int base, int32_t disp, int32_t imm) { rex(false, 0, 0, base); u8(0xC7); mem(0, base, disp); u32(imm); }
+
+    void push(int r) { if (r & 8) u8(0x41); u8(0x50 + (r & 7)); }
+    void pop(int r)  { if (r & 8) u8(0x41); u8(0x58 + (r & 7)); }
+
+    // desvios de 32 bits: devolvem a posição do deslocamento a corrigir
+    std::size_t jcc(int cc) { u8(0x0F); u8(0x80 + cc); u32(0); return pos() - 4; }
+    std::size_t jmp()       { u8(0xE9); u32(0); return pos() - 4; }
+};
+
+constexpr int32_t OFF_MEM   = offsetof(BipJitCodigo::Contexto, mem);
+constexpr int32_t OFF_PILHA = offsetof(BipJitCodigo::Contexto, pilha);
+constexpr int32_t OFF_PROF  = offsetof(BipJitCodigo::Contexto, prof);
+constexpr int32_t OFF_MAX   = offsetof(BipJitCodigo::Contexto, maxPilha);
+constexpr int32_t OFF_ORC   = offsetof(BipJitCodigo::Contexto, orc);
+constexpr int32_t OFF_EXTRA = offsetof(BipJitCodigo::Contexto, extra);
+constexpr int32_t OFF_TAB   = offsetof(BipJitCodigo::Contexto, tab);
+constexpr int32_t OFF_PC    = offsetof(BipJitCodigo::Contexto, pc);
+constexpr int32_t OFF_ACC   = offsetof(BipJitCodigo::Contexto, acc);
+constexpr int32_t OFF_STAT  = offsetof(BipJitCodigo::Contexto, status);
+constexpr int32_t OFF_INDR  = offsetof(BipJitCodigo::Contexto, indr);
+
+bool ehDesvio(BipOp op) {
+    return bipIsJump(op) || op == BipOp::RETURN;
+}
+
+// condição (sobre STATUS) que NÃO desvia, para BEQ..BLE
+int condContraria(BipOp op) {
+    switch (op) {
+    case BipOp::BEQ: return CC_NE;
+    case BipOp::BNE: return CC_E;
+    case BipOp::BGT: return CC_LE;
+    case BipOp::BGE: return CC_L;
+    case BipOp::BLT: return CC_GE;
+    case BipOp::BLE: return CC_G;
+    default:         return -1;
+    }
+}
+
+// o JIT traduz tudo menos E/S, HLT e pseudo-instruções
+bool traduz(const BipVmInstr& in) {
+    if (in.modo == BipModo::Entrada || in.modo == BipModo::Saida) return false;
+    return in.op != BipOp::HLT && in.op != BipOp::Label && in.op != BipOp::Raw;
+}
+
+} // namespace
+
+std::shared_ptr<const BipJitCodigo> BipJitCodigo::compila(const BipImage& img) {
+    const std::vector<BipVmInstr>& cod = img.codigo;
+    const int n = static_cast<int>(cod.size());
+
+    // líderes: entrada, destinos, depois de desvios, e em volta do que não é traduzido
+    std::vector<char> lider(n + 1, 0);
+    lider[0] = 1;
+    lider[n] = 1;
+    if (img.entrada >= 0 && img.entrada <= n) lider[img.entrada] = 1;
+    for (int i = 0; i < n; ++i) {
+        const BipVmInstr& in = cod[i];
+        if (in.modo == BipModo::Codigo && in.arg >= 0 && in.arg <= n) lider[in.arg] = 1;
+        if (ehDesvio(in.op) || !traduz(in)) lider[i + 1] = 1;
+        if (!traduz(in)) lider[i] = 1;
+    }
+
+    Emissor e;
+    struct Salto  { std::size_t pos; int pc; };          // para o código da instrução 'pc'
+    struct Saida  { int pc; int devolve; };              // volta ao interpretador em 'pc'
+    struct Fria   { std::size_t pos; int saida; };
+    std::vector<Salto> saltos;
+    std::vector<Saida> saidas;
+    std::vector<Fria>  frias;
+    std::vector<long>  codigoDe(n + 1, -1);              // pc -> deslocamento no buffer
+
+    auto saltaPara = [&](std::size_t pos, int pc) { saltos.push_back({ pos, pc }); };
+    auto sai = [&](std::size_t pos, int pc, int devolve) {
+        frias.push_back({ pos, static_cast<int>(saidas.size()) });
+        saidas.push_back({ pc, devolve });
+    };
+
+    // entrada: void f(Contexto* rdi)
+    for (int r : { RBX, RBP, R12, R13, R14, R15 }) e.push(r);
+    e.opRR(0x89, CTX, RDI, true);
+    e.ld64(MEM, CTX, OFF_MEM);
+    e.ld64(ORC, CTX, OFF_ORC);
+    e.ld32(ACC, CTX, OFF_ACC);
+    e.ld32(STATUS, CTX, OFF_STAT);
+    e.ld32(INDR, CTX, OFF_INDR);
+    e.movsxd(RAX, CTX, OFF_PC);
+    e.ld64(RCX, CTX, OFF_TAB);
+    e.u8(0xFF); e.u8(0x24); e.u8(0xC1);                  // jmp [rcx + rax*8]
+    const std::size_t epilogo = e.pos();
+    e.st64(CTX, OFF_ORC, ORC);
+    e.st32(CTX, OFF_ACC, ACC);
+    e.st32(CTX, OFF_STAT, STATUS);
+    e.st32(CTX, OFF_INDR, INDR);
+    for (int r : { R15, R14, R13, R12, RBP, RBX }) e.pop(r);
+    e.u8(0xC3);
+
+    // operando de leitura em 'r' (16 bits estendido com sinal)
+    auto carrega = [&](int r, const BipVmInstr& in, int semOperando) {
+        switch (in.modo) {
+        case BipModo::Imediato: e.movRI(r, static_cast<int16_t>(in.arg)); break;
+        case BipModo::Memoria:  e.movsxRM(r, MEM, in.arg * 2);             break;
+        case BipModo::Indr:     e.movRR(r, INDR);                          break;
+        default:                e.movRI(r, semOperando);                   break;
+        }
+    };
+    auto fechaUla = [&](bool estende) {                  // trunca ACC em 16 bits e copia em STATUS
+        if (estende) e.movsxRR(ACC, ACC);
+        e.movRR(STATUS, ACC);
+    };
+
+    for (int i = 0; i < n; ) {
+        if (!traduz(cod[i])) { ++i; continue; }
+        int fim = i + 1;
+        while (fim < n && !lider[fim]) ++fim;
+
+        codigoDe[i] = static_cast<long>(e.pos());
+        e.opRI(5, ORC, fim - i, true);                   // sub rbp, tamanho
+        sai(e.jcc(CC_L), i, fim - i);
+
+        for (int p = i; p < fim; ++p) {
+            const BipVmInstr& in = cod[p];
+            switch (in.op) {
+            case BipOp::LD:   carrega(ACC, in, 0); break;
+            case BipOp::LDI:  e.movRI(ACC, static_cast<int16_t>(in.arg)); break;
+            case BipOp::STO:
+                if (in.modo == BipModo::Memoria)   e.sto16(MEM, in.arg * 2, ACC);
+                else if (in.modo == BipModo::Indr) e.movRR(INDR, ACC);
+                break;
+            case BipOp::LDV:
+            case BipOp::STOV:
+                e.opRI(7, INDR, in.tam);                 // índice sem sinal >= tamanho: para
+                sai(e.jcc(CC_AE), p, fim - p);
+                if (in.op == BipOp::LDV) e.movsxRMIdx(ACC, MEM, INDR, in.arg * 2);
+                else                     e.sto16Idx(MEM, INDR, in.arg * 2, ACC);
+                break;
+
+            case BipOp::ADD: case BipOp::ADDI:
+            case BipOp::SUB: case BipOp::SUBI:
+            case BipOp::AND: case BipOp::ANDI:
+            case BipOp::OR:  case BipOp::ORI:
+            case BipOp::XOR: case BipOp::XORI: {
+                static const struct { BipOp a, b; int ext, op; } ops[] = {
+                    { BipOp::ADD, BipOp::ADDI, 0, 0x01 }, { BipOp::SUB, BipOp::SUBI, 5, 0x29 },
+                    { BipOp::AND, BipOp::ANDI, 4, 0x21 }, { BipOp::OR,  BipOp::ORI,  1, 0x09 },
+                    { BipOp::XOR, BipOp::XORI, 6, 0x31 },
+                };
+                int ext = 0, op = 0;
+                for (const auto& o : ops)
+                    if (in.op == o.a || in.op == o.b) { ext = o.ext; op = o.op; }
+                if (in.modo == BipModo::Imediato) {
+                    e.opRI(ext, ACC, static_cast<int16_t>(in.arg));
+                } else {
+                    carrega(RAX, in, 0);
+                    e.opRR(op, ACC, RAX);
+                }
+                // AND/OR/XOR de valores estendidos já saem estendidos
+                fechaUla(ext == 0 || ext == 5);
+                break;
+            }
+            case BipOp::MUL: case BipOp::MULI:
+                if (in.modo == BipModo::Imediato) {
+                    e.imulRRI(ACC, ACC, static_cast<int16_t>(in.arg));
+                } else {
+                    carrega(RAX, in, 0);
+                    e.imulRR(ACC, RAX);
+                }
+                fechaUla(true);
+                break;
+            case BipOp::DIV: case BipOp::DIVI:
+            case BipOp::MOD: case BipOp::MODI: {
+                carrega(RCX, in, 0);
+                e.opRR(0x85, RCX, RCX);
+                sai(e.jcc(CC_E), p, fim - p);
+                e.movRR(RAX, ACC);
+                e.cdq();
+                e.grupoF7(7, RCX);
+                const bool div = in.op == BipOp::DIV || in.op == BipOp::DIVI;
+                e.movRR(ACC, div ? RAX : RDX);
+                fechaUla(true);
+                break;
+            }
+            case BipOp::NOT:
+                e.grupoF7(2, ACC);
+                fechaUla(false);
+                break;
+            case BipOp::SLL: case BipOp::SHL:
+            case BipOp::SRL: case BipOp::SHR: {
+                const int ext = (in.op == BipOp::SLL || in.op == BipOp::SHL) ? 4 : 5;
+                if (in.modo == BipModo::Imediato || in.modo == BipModo::Nenhum) {
+                    const int k = in.modo == BipModo::Nenhum ? 1 : static_cast<int16_t>(in.arg);
+                    if (k < 0 || k > 15) {
+                        e.movRI(ACC, 0);
+                    } else {
+                        e.movzxRR(ACC, ACC);
+                        e.shiftI(ext, ACC, k);
+                    }
+                } else {
+                    carrega(RCX, in, 1);
+                    e.movzxRR(RAX, ACC);
+                    e.shiftCl(ext, RAX);
+                    e.movRI(RDX, 0);
+                    e.opRI(7, RCX, 15);
+                    e.cmov(CC_A, RAX, RDX);             // k fora de 0..15 dá 0
+                    e.movRR(ACC, RAX);
+                }
+                fechaUla(true);
+                break;
+            }
+
+            case BipOp::JMP:
+                e.inc64M(CTX, OFF_EXTRA);
+                saltaPara(e.jmp(), in.arg);
+                break;
+            case BipOp::JZ:
+            case BipOp::BEQ: case BipOp::BNE:
+            case BipOp::BGT: case BipOp::BGE:
+            case BipOp::BLT: case BipOp::BLE:
+                if (in.op == BipOp::JZ) {
+                    e.opRR(0x85, ACC, ACC);
+                    saltaPara(e.jcc(CC_NE), p + 1);
+                } else {
+                    e.opRR(0x85, STATUS, STATUS);
+                    saltaPara(e.jcc(condContraria(in.op)), p + 1);
+                }
+                e.inc64M(CTX, OFF_EXTRA);
+                saltaPara(e.jmp(), in.arg);
+                break;
+            case BipOp::CALL:
+                e.ld64(RAX, CTX, OFF_PROF);
+                e.cmp64RM(RAX, CTX, OFF_MAX);
+                sai(e.jcc(CC_GE), p, fim - p);
+                e.ld64(RCX, CTX, OFF_PILHA);
+                e.u8(0xC7); e.u8(0x04); e.u8(0x81); e.u32(p + 1);    // mov dword [rcx + rax*4], p+1
+                e.u8(0x48); e.u8(0xFF); e.u8(0xC0);                  // inc rax
+                e.st64(CTX, OFF_PROF, RAX);
+                e.inc64M(CTX, OFF_EXTRA);
+                saltaPara(e.jmp(), in.arg);
+                break;
+            case BipOp::RETURN:
+                e.ld64(RAX, CTX, OFF_PROF);
+                e.opRR(0x85, RAX, RAX, true);
+                sai(e.jcc(CC_E), p, fim - p);                        // RETURN de main
+                e.u8(0x48); e.u8(0xFF); e.u8(0xC8);                  // dec rax
+                e.st64(CTX, OFF_PROF, RAX);
+                e.ld64(RCX, CTX, OFF_PILHA);
+                e.u8(0x8B); e.u8(0x04); e.u8(0x81);                  // mov eax, [rcx + rax*4]
+                e.inc64M(CTX, OFF_EXTRA);
+                e.ld64(RCX, CTX, OFF_TAB);
+                e.u8(0xFF); e.u8(0x24); e.u8(0xC1);                  // jmp [rcx + rax*8]
+                break;
+            default:
+                break;
+            }
+        }
+        // bloco que termina sem desvio: segue para 'fim' (o próximo bloco, se for traduzido)
+        if (!ehDesvio(cod[fim - 1].op) && (fim == n || !traduz(cod[fim])))
+            saltaPara(e.jmp(), fim);
+        i = fim;
+    }
+
+    auto voltaAoEpilogo = [&]() {
+        const std::size_t d = e.jmp();
+        e.patch32(d, static_cast<int32_t>(static_cast<long>(epilogo) - static_cast<long>(d + 4)));
+    };
+
+    // o que não começa bloco volta ao interpretador
+    for (int pc = 0; pc <= n; ++pc) {
+        if (codigoDe[pc] >= 0) continue;
+        codigoDe[pc] = static_cast<long>(e.pos());
+        e.mov32MI(CTX, OFF_PC, pc);
+        voltaAoEpilogo();
+    }
+    std::vector<std::size_t> saidaEm(saidas.size());
+    for (std::size_t k = 0; k < saidas.size(); ++k) {
+        saidaEm[k] = e.pos();
+        e.opRI(0, ORC, saidas[k].devolve, true);         // add rbp, instruções não executadas
+        e.mov32MI(CTX, OFF_PC, saidas[k].pc);
+        voltaAoEpilogo();
+    }
+    for (const Salto& s : saltos)
+        e.patch32(s.pos, static_cast<int32_t>(codigoDe[s.pc] - static_cast<long>(s.pos + 4)));
+    for (const Fria& f : frias)
+        e.patch32(f.pos, static_cast<int32_t>(static_cast<long>(saidaEm[f.saida]) - static_cast<long>(f.pos + 4)));
+
+    const std::size_t pagina  = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    const std::size_t tamanho = (e.b.size() + pagina - 1) / pagina * pagina;
+    void* buf = mmap(nullptr, tamanho, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf == MAP_FAILED)
+        return nullptr;
+    std::memcpy(buf, e.b.data(), e.b.size());
+    if (mprotect(buf, tamanho, PROT_READ | PROT_EXEC) != 0) {
+        munmap(buf, tamanho);
+        return nullptr;
+    }
+
+    std::shared_ptr<BipJitCodigo> jit(new BipJitCodigo());
+    jit->buffer_  = buf;
+    jit->tamanho_ = tamanho;
+    jit->entrada_ = reinterpret_cast<void (*)(Contexto*)>(buf);
+    jit->tabela_.resize(n + 1);
+    for (int pc = 0; pc <= n; ++pc)
+        jit->tabela_[pc] = static_cast<const uint8_t*>(buf) + codigoDe[pc];
+    return jit;
+}
+
+BipJitCodigo::~BipJitCodigo() {
+    if (buffer_)
+        munmap(buffer_, tamanho_);
+}
+
+void BipJitCodigo::executa(Contexto& c) const {
+    c.tab = tabela_.data();
+    entrada_(&c);
+}
+
+#else
+
+std::shared_ptr<const BipJitCodigo> BipJitCodigo::compila(const BipImage&) {
+    return nullptr;
+}
+
+BipJitCodigo::~BipJitCodigo() = default;
+
+void BipJitCodigo::executa(Contexto&) const { }
+
+#endif // BIPJIT_X86_64
@@ -0,0 +1,62 @@
+#ifndef BIPJIT_H
+#define BIPJIT_H
+
+#include "bipvm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// =================== JIT da BIP para x86-64 ===================
+// Traduz cada bloco básico de um BipImage para código de máquina num buffer
+// mmap'd executável (só x86-64/Linux; nos outros BipVm::jitDisponivel() é
+// false e a BipVm usa o Threaded).
+//
+// Registradores fixos: ACC em r12d, STATUS em r13d, $indr em r14d (todos
+// com o valor de 16 bits estendido com sinal), a memória de dados (plana,
+// int16_t) em r15, o orçamento de instruções em rbp e o Contexto em rbx.
+// Cada bloco desconta o seu tamanho do orçamento ao entrar.
+//
+// O código volta para BipVm::interpreta (que executa uma instrução e chama
+// o JIT de novo) nas instruções que ele não traduz - $in_port/$out_port e
+// HLT -, antes de uma instrução que pararia a execução (índice fora do
+// vetor, divisão por zero, pilha cheia, RETURN de main), quando o bloco não
+// cabe no orçamento e no fim do código. Assim saída, ciclos, contagem de
+// instruções e motivo de parada são sempre os do Switch.
+class BipJitCodigo {
+public:
+    // estado trocado com o código gerado (os deslocamentos entram no código)
+    struct Contexto {
+        int16_t*           mem      = nullptr;
+        int32_t*           pilha    = nullptr;   // lim.pilha posições
+        int64_t            prof     = 0;
+        int64_t            maxPilha = 0;
+        int64_t            orc      = 0;         // instruções que ainda podem executar
+        uint64_t           extra    = 0;         // ciclos além de 1 por instrução
+        const void* const* tab      = nullptr;   // pc -> código
+        int32_t            pc = 0, acc = 0, status = 0, indr = 0;
+    };
+
+    // nullptr se a memória executável não puder ser reservada
+    static std::shared_ptr<const BipJitCodigo> compila(const BipImage& img);
+
+    ~BipJitCodigo();
+    BipJitCodigo(const BipJitCodigo&) = delete;
+    BipJitCodigo& operator=(const BipJitCodigo&) = delete;
+
+    // roda a partir de c.pc até sair para o interpretador (c.pc = próxima instrução)
+    void executa(Contexto& c) const;
+
+    std::size_t bytes() const { return tamanho_; }
+
+private:
+    BipJitCodigo() = default;
+
+    void*                    buffer_  = nullptr;
+    std::size_t              tamanho_ = 0;
+    std::vector<const void*> tabela_;        // pc (0..n) -> código; n = fim do código
+    void (*entrada_)(Contexto*) = nullptr;
+};
+
+#endif // BIPJIT_H
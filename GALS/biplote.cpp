@@ -0,0 +1,101 @@
+#include "biplote.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// vetores [ini, fim) que ainda faltam a uma thread; o dono tira do início,
+// quem rouba leva a metade final
+struct alignas(64) Faixa {
+    std::mutex  m;
+    std::size_t ini = 0;
+    std::size_t fim = 0;
+};
+
+} // namespace
+
+int ResultadoLote::erros() const {
+    int n = 0;
+    for (const ResultadoExecucao& r : resultados)
+        if (!r.ok()) ++n;
+    return n;
+}
+
+ResultadoLote bipExecutaLote(const BipVm& vm, const std::vector<std::vector<int>>& entradas,
+                             const BipVm::Limites& lim, unsigned threads) {
+    using Relogio = std::chrono::steady_clock;
+
+    ResultadoLote lote;
+    const std::size_t n = entradas.size();
+    lote.resultados.resize(n);
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, n)));
+    lote.threads = threads;
+
+    std::unique_ptr<Faixa[]> faixas(new Faixa[threads]);
+    for (unsigned t = 0; t < threads; ++t) {
+        faixas[t].ini = n * t / threads;
+        faixas[t].fim = n * (t + 1) / threads;
+    }
+    std::atomic<uint64_t> roubos(0);
+
+    // próximo vetor da thread 'eu'; false quando não sobrou nada em lugar nenhum
+    auto proximo = [&](unsigned eu, std::size_t& i) {
+        {
+            std::lock_guard<std::mutex> g(faixas[eu].m);
+            if (faixas[eu].ini < faixas[eu].fim) {
+                i = faixas[eu].ini++;
+                return true;
+            }
+        }
+        // nenhum vetor novo aparece durante o lote: uma volta sem achar trabalho encerra
+        for (unsigned k = 1; k < threads; ++k) {
+            Faixa& v = faixas[(eu + k) % threads];
+            std::size_t ini, fim;
+            {
+                std::lock_guard<std::mutex> g(v.m);
+                if (v.ini >= v.fim) continue;
+                fim = v.fim;
+                ini = v.ini + (v.fim - v.ini) / 2;
+                v.fim = ini;
+            }
+            roubos.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> g(faixas[eu].m);
+            i = ini;
+            faixas[eu].ini = ini + 1;
+            faixas[eu].fim = fim;
+            return true;
+        }
+        return false;
+    };
+
+    auto trabalhador = [&](unsigned eu) {
+        std::size_t i;
+        while (proximo(eu, i))
+            lote.resultados[i] = vm.run(entradas[i], lim);
+    };
+
+    const Relogio::time_point inicio = Relogio::now();
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (unsigned t = 1; t < threads; ++t)
+        pool.emplace_back(trabalhador, t);
+    trabalhador(0);
+    for (std::thread& th : pool)
+        th.join();
+    lote.segundos = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    lote.roubos = roubos.load();
+    for (const ResultadoExecucao& r : lote.resultados) {
+        lote.instrucoes += r.instrucoes;
+        lote.ciclos += r.ciclos;
+    }
+    return lote;
+}
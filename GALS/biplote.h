@@ -0,0 +1,32 @@
+#ifndef BIPLOTE_H
+#define BIPLOTE_H
+
+#include "bipvm.h"
+
+#include <cstdint>
+#include <vector>
+
+// =================== Execução em lote ===================
+// Roda o mesmo programa montado com muitos vetores de entrada ($in_port),
+// espalhados por um pool de threads com roubo de trabalho: cada thread
+// começa com uma faixa contígua dos vetores e, quando a sua acaba, rouba a
+// metade final da faixa de outra. Todas compartilham a BipVm (montada e
+// pré-decodificada uma vez; run é const); cada execução tem a sua própria
+// cópia da memória, feita a partir da imagem da .data.
+struct ResultadoLote {
+    std::vector<ResultadoExecucao> resultados;   // na ordem das entradas
+    uint64_t instrucoes = 0;
+    uint64_t ciclos     = 0;
+    uint64_t roubos     = 0;     // faixas roubadas entre threads
+    unsigned threads    = 0;
+    double   segundos   = 0.0;
+
+    int    erros() const;        // execuções que não terminaram bem (!ok())
+    double ciclosPorSegundo() const { return segundos > 0.0 ? double(ciclos) / segundos : 0.0; }
+};
+
+// threads = 0 usa os núcleos da máquina (nunca mais threads que entradas)
+ResultadoLote bipExecutaLote(const BipVm& vm, const std::vector<std::vector<int>>& entradas,
+                             const BipVm::Limites& lim, unsigned threads = 0);
+
+#endif // BIPLOTE_H
@@ -0,0 +1,173 @@
+#include "bipperfil.h"
+
+#include <algorithm>
+#include <cstdio>
+
+void BipPerfil::reinicia(std::size_t instrucoes) {
+    execucoes.assign(instrucoes, 0);
+    ciclos.assign(instrucoes, 0);
+    chamadas.assign(1, Chamada());
+    atual = 0;
+    filhos_.clear();
+}
+
+void BipPerfil::entra(int funcao) {
+    const uint64_t chave = (uint64_t(uint32_t(atual)) << 32) | uint32_t(funcao);
+    auto it = filhos_.find(chave);
+    if (it == filhos_.end()) {
+        Chamada c;
+        c.pai = atual;
+        c.funcao = funcao;
+        chamadas.push_back(c);
+        it = filhos_.emplace(chave, static_cast<int>(chamadas.size()) - 1).first;
+    }
+    atual = it->second;
+}
+
+namespace {
+
+std::vector<std::string_view> linhas(std::string_view texto) {
+    std::vector<std::string_view> v;
+    std::size_t ini = 0;
+    while (ini < texto.size()) {
+        std::size_t fim = texto.find('\n', ini);
+        if (fim == std::string_view::npos) fim = texto.size();
+        std::string_view l = texto.substr(ini, fim - ini);
+        if (!l.empty() && l.back() == '\r') l.remove_suffix(1);
+        v.push_back(l);
+        ini = fim + 1;
+    }
+    return v;
+}
+
+std::string_view apara(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t')) s.remove_suffix(1);
+    return s;
+}
+
+double porcento(uint64_t parte, uint64_t total) {
+    return total ? 100.0 * double(parte) / double(total) : 0.0;
+}
+
+// nome de uma função: o primeiro rótulo na instrução de destino
+std::string nomeEm(const BipImage& img, int pc) {
+    for (const BipVmRotulo& r : img.rotulos)
+        if (r.pc == pc) return r.nome;
+    return "@" + std::to_string(pc);
+}
+
+} // namespace
+
+std::string bipListagemPerfil(const BipImage& img, const BipPerfil& perfil,
+                              std::string_view assembly, const std::vector<int>& linhaFonte,
+                              std::string_view fonte) {
+    const std::vector<std::string_view> asmLinhas = linhas(assembly);
+    const std::vector<std::string_view> fonteLinhas = linhas(fonte);
+    const int n = static_cast<int>(img.codigo.size());
+
+    uint64_t execucoes = 0, ciclos = 0;
+    for (int i = 0; i < n; ++i) {
+        execucoes += perfil.execucoes[i];
+        ciclos += perfil.ciclos[i];
+    }
+
+    // linha do assembly (0..) -> instrução; instrução -> linha do fonte
+    std::vector<int> instrDaLinha(asmLinhas.size(), -1);
+    for (int i = 0; i < n; ++i)
+        if (img.linha[i] >= 1 && img.linha[i] <= static_cast<int>(asmLinhas.size()))
+            instrDaLinha[img.linha[i] - 1] = i;
+    auto fonteDaLinha = [&](std::size_t l) {
+        return l < linhaFonte.size() ? linhaFonte[l] : 0;
+    };
+    auto textoFonte = [&](int l) {
+        return l >= 1 && l <= static_cast<int>(fonteLinhas.size()) ? apara(fonteLinhas[l - 1])
+                                                                   : std::string_view();
+    };
+
+    std::string out;
+    char buf[96];
+    std::snprintf(buf, sizeof buf, "; perfil: %llu instruções, %llu ciclos\n",
+                  (unsigned long long) execucoes, (unsigned long long) ciclos);
+    out += buf;
+    out += ";\n;      vezes      ciclos       %  assembly\n";
+
+    int ultimaFonte = 0;
+    for (std::size_t l = 0; l < asmLinhas.size(); ++l) {
+        const int f = fonteDaLinha(l);
+        if (f > 0 && f != ultimaFonte) {
+            out += "; [" + std::to_string(f) + "] ";
+            out += textoFonte(f);
+            out += '\n';
+            ultimaFonte = f;
+        }
+        const int i = instrDaLinha[l];
+        if (i >= 0 && perfil.execucoes[i] > 0) {
+            std::snprintf(buf, sizeof buf, "%12llu %11llu %6.2f%%  ",
+                          (unsigned long long) perfil.execucoes[i],
+                          (unsigned long long) perfil.ciclos[i], porcento(perfil.ciclos[i], ciclos));
+            out += buf;
+        } else {
+            out.append(33, ' ');
+        }
+        out += asmLinhas[l];
+        out += '\n';
+    }
+
+    // por rótulo: do rótulo até o próximo; rótulos no mesmo ponto dividem o trecho
+    out += ";\n; por rótulo\n;      vezes instruções      ciclos       %  rótulo\n";
+    for (std::size_t k = 0; k < img.rotulos.size();) {
+        const int ini = img.rotulos[k].pc;
+        std::string nomes;
+        for (; k < img.rotulos.size() && img.rotulos[k].pc == ini; ++k)
+            nomes += (nomes.empty() ? "" : ", ") + img.rotulos[k].nome;
+        const int fim = k < img.rotulos.size() ? img.rotulos[k].pc : n;
+        if (ini >= fim) continue;
+        uint64_t c = 0;
+        for (int i = ini; i < fim; ++i)
+            c += perfil.ciclos[i];
+        std::snprintf(buf, sizeof buf, ";%11llu %11d %11llu %6.2f%%  ",
+                      (unsigned long long) perfil.execucoes[ini], fim - ini,
+                      (unsigned long long) c, porcento(c, ciclos));
+        out += buf + nomes + '\n';
+    }
+
+    // por linha do fonte, das mais caras para as mais baratas
+    std::vector<std::pair<int, uint64_t>> porLinha;   // (linha, ciclos)
+    std::vector<uint64_t> soma(fonteLinhas.size() + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        const int f = fonteDaLinha(static_cast<std::size_t>(img.linha[i] - 1));
+        soma[f < static_cast<int>(soma.size()) ? f : 0] += perfil.ciclos[i];
+    }
+    for (std::size_t f = 0; f < soma.size(); ++f)
+        if (soma[f] > 0) porLinha.emplace_back(static_cast<int>(f), soma[f]);
+    std::stable_sort(porLinha.begin(), porLinha.end(),
+                     [](const auto& a, const auto& b) { return a.second > b.second; });
+    out += ";\n; por linha do fonte\n;     ciclos       %  linha\n";
+    for (const auto& [f, c] : porLinha) {
+        std::snprintf(buf, sizeof buf, ";%11llu %6.2f%%  ", (unsigned long long) c, porcento(c, ciclos));
+        out += buf;
+        if (f == 0) {
+            out += "(sem linha: entrada e biblioteca)\n";
+        } else {
+            out += "[" + std::to_string(f) + "] ";
+            out += textoFonte(f);
+            out += '\n';
+        }
+    }
+    return out;
+}
+
+std::string bipPilhasDobradas(const BipImage& img, const BipPerfil& perfil) {
+    // caminho de cada nó (os pais sempre vêm antes dos filhos)
+    std::vector<std::string> caminho(perfil.chamadas.size());
+    std::string out;
+    for (std::size_t k = 0; k < perfil.chamadas.size(); ++k) {
+        const BipPerfil::Chamada& c = perfil.chamadas[k];
+        caminho[k] = c.pai < 0 ? nomeEm(img, img.entrada)
+                               : caminho[c.pai] + ';' + nomeEm(img, c.funcao);
+        if (c.ciclos > 0)
+            out += caminho[k] + ' ' + std::to_string(c.ciclos) + '\n';
+    }
+    return out;
+}
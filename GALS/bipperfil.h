@@ -0,0 +1,56 @@
+#ifndef BIPPERFIL_H
+#define BIPPERFIL_H
+
+#include "bipvm.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// =================== Perfil de execução da BIP ===================
+// BipVm::run(entrada, lim, perfil) conta as execuções e os ciclos de cada
+// instrução e os ciclos de cada cadeia de CALL (a partir de main). Os
+// relatórios cruzam isso com o texto do assembly e com o mapa de linhas do
+// fonte que o compilador produz (ResultadoCompilacao::linhaFonte).
+struct BipPerfil {
+    // nó da árvore de chamadas; o nó 0 é a execução fora de qualquer CALL
+    struct Chamada {
+        int      pai    = -1;
+        int      funcao = -1;   // instrução de destino do CALL (-1 na raiz)
+        uint64_t ciclos = 0;    // ciclos próprios (sem os das chamadas feitas)
+    };
+
+    std::vector<uint64_t> execucoes;   // por instrução
+    std::vector<uint64_t> ciclos;      // por instrução
+    std::vector<Chamada>  chamadas;
+    int                   atual = 0;   // nó da cadeia em execução
+
+    void reinicia(std::size_t instrucoes);
+
+    void conta(int pc, int c) {
+        ++execucoes[pc];
+        ciclos[pc] += c;
+        chamadas[atual].ciclos += c;
+    }
+    void entra(int funcao);
+    void sai() { if (chamadas[atual].pai >= 0) atual = chamadas[atual].pai; }
+
+private:
+    std::unordered_map<uint64_t, int> filhos_;   // (pai, função) -> nó
+};
+
+// Listagem do assembly com execuções, ciclos e % de cada instrução e a linha
+// do fonte antes de cada trecho que ela gerou; depois os totais por rótulo
+// (do rótulo até o próximo) e por linha do fonte. 'linhaFonte' pode ser vazio.
+std::string bipListagemPerfil(const BipImage& img, const BipPerfil& perfil,
+                              std::string_view assembly, const std::vector<int>& linhaFonte,
+                              std::string_view fonte);
+
+// Pilhas dobradas ("main;FUNC_f;FUNC_g ciclos", uma cadeia por linha), o
+// formato de entrada do flamegraph.pl e do speedscope.
+std::string bipPilhasDobradas(const BipImage& img, const BipPerfil& perfil);
+
+#endif // BIPPERFIL_H
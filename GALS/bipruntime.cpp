@@ -0,0 +1,173 @@
+#include "bipruntime.h"
+
+namespace {
+
+struct Rotina {
+    const char*                   rotulo;
+    std::vector<std::string_view> codigo;
+    unsigned                      deps;
+};
+
+// Multiplicação por somas e deslocamentos: percorre os bits do direito
+// (SRL até zerar) somando o esquerdo deslocado. Vale para negativos, pois
+// o produto módulo 2^16 não depende do sinal.
+const Rotina kMul = { "__MUL", {
+    "__MUL:",
+    "STO __RT_B",
+    "LDI 0",
+    "STO __RT_R",
+    "__MUL_LACO:",
+    "LD __RT_B",
+    "JZ __MUL_FIM",
+    "ANDI 1",
+    "JZ __MUL_PAR",
+    "LD __RT_R",
+    "ADD __RT_A",
+    "STO __RT_R",
+    "__MUL_PAR:",
+    "LD __RT_A",
+    "SLL 1",
+    "STO __RT_A",
+    "LD __RT_B",
+    "SRL 1",
+    "STO __RT_B",
+    "JMP __MUL_LACO",
+    "__MUL_FIM:",
+    "LD __RT_R",
+    "RETURN 0",
+}, 0 };
+
+const Rotina kDiv = { "__DIV", {
+    "__DIV:",
+    "CALL __DIVMOD",
+    "LD __RT_Q",
+    "RETURN 0",
+}, bipRoutineBit(BipRoutine::DivMod) };
+
+const Rotina kMod = { "__MOD", {
+    "__MOD:",
+    "CALL __DIVMOD",
+    "LD __RT_R",
+    "RETURN 0",
+}, bipRoutineBit(BipRoutine::DivMod) };
+
+// Divisão com restauração sobre os módulos, 16 passos. Os desvios da BIP
+// comparam com sinal: o resto parcial R < |B| <= 0x7FFF só passa de 0x7FFF
+// ao deslocar quando R >= 0x4000 (__RT_T), e então R >= |B| com certeza.
+// |B| = 0x8000 (B = -32768) é tratado à parte.
+const Rotina kDivMod = { "__DIVMOD", {
+    "__DIVMOD:",
+    "STO __RT_B",
+    "LDI 0",
+    "STO __RT_Q",
+    "STO __RT_R",
+    "LD __RT_A",
+    "STO __RT_SR",              // < 0: resto negativo
+    "XOR __RT_B",
+    "STO __RT_SQ",              // < 0: quociente negativo
+    "LD __RT_A",
+    "SUBI 0",
+    "BGE __DM_APOS",
+    "LDI 0",
+    "SUB __RT_A",
+    "STO __RT_A",
+    "__DM_APOS:",
+    "LD __RT_B",
+    "SUBI 0",
+    "BGE __DM_BPOS",
+    "LDI 0",
+    "SUB __RT_B",
+    "STO __RT_B",
+    "SUBI 0",
+    "BLT __DM_BMIN",            // continua negativo: era -32768
+    "__DM_BPOS:",
+    "LDI 16",
+    "STO __RT_N",
+    "__DM_LACO:",
+    "LD __RT_R",
+    "SRL 14",
+    "STO __RT_T",
+    "LD __RT_A",
+    "SRL 15",
+    "STO __RT_U",               // bit que desce do dividendo
+    "LD __RT_R",
+    "SLL 1",
+    "OR __RT_U",
+    "STO __RT_R",
+    "LD __RT_A",
+    "SLL 1",
+    "STO __RT_A",
+    "LD __RT_Q",
+    "SLL 1",
+    "STO __RT_Q",
+    "LD __RT_T",
+    "JZ __DM_CMP",
+    "JMP __DM_SUB",
+    "__DM_CMP:",
+    "LD __RT_R",
+    "SUB __RT_B",
+    "BLT __DM_PROX",
+    "__DM_SUB:",
+    "LD __RT_R",
+    "SUB __RT_B",
+    "STO __RT_R",
+    "LD __RT_Q",
+    "ORI 1",
+    "STO __RT_Q",
+    "__DM_PROX:",
+    "LD __RT_N",
+    "SUBI 1",
+    "STO __RT_N",
+    "BNE __DM_LACO",
+    "JMP __DM_SINAL",
+    "__DM_BMIN:",               // |A| <= 0x8000: quociente 1 só se A = -32768
+    "LD __RT_A",
+    "SUB __RT_B",
+    "JZ __DM_UM",
+    "LD __RT_A",
+    "STO __RT_R",
+    "JMP __DM_SINAL",
+    "__DM_UM:",
+    "LDI 1",
+    "STO __RT_Q",
+    "__DM_SINAL:",
+    "LD __RT_SQ",
+    "SUBI 0",
+    "BGE __DM_RSINAL",
+    "LDI 0",
+    "SUB __RT_Q",
+    "STO __RT_Q",
+    "__DM_RSINAL:",
+    "LD __RT_SR",
+    "SUBI 0",
+    "BGE __DM_FIM",
+    "LDI 0",
+    "SUB __RT_R",
+    "STO __RT_R",
+    "__DM_FIM:",
+    "RETURN 0",
+}, 0 };
+
+const Rotina* const kRotinas[kBipRoutineCount] = { &kMul, &kDiv, &kMod, &kDivMod };
+
+} // namespace
+
+const char* bipRoutineLabel(BipRoutine r) {
+    return kRotinas[static_cast<int>(r)]->rotulo;
+}
+
+const std::vector<std::string_view>& bipRoutineCode(BipRoutine r) {
+    return kRotinas[static_cast<int>(r)]->codigo;
+}
+
+unsigned bipRoutineDeps(BipRoutine r) {
+    return kRotinas[static_cast<int>(r)]->deps;
+}
+
+const std::vector<std::string_view>& bipRuntimeData() {
+    static const std::vector<std::string_view> dados = {
+        "__RT_A", "__RT_B", "__RT_Q", "__RT_R", "__RT_N",
+        "__RT_T", "__RT_U", "__RT_SQ", "__RT_SR",
+    };
+    return dados;
+}
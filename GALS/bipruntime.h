@@ -0,0 +1,38 @@
+#ifndef BIPRUNTIME_H
+#define BIPRUNTIME_H
+
+#include <string_view>
+#include <vector>
+
+// =================== Biblioteca de execução ===================
+// A BIP não tem MUL/DIV/MOD. O gerador chama estas sub-rotinas, que entram
+// no fim do .text (e suas variáveis na .data) só quando algum CALL as usa.
+//
+// Convenção: operando esquerdo em __RT_A, direito no ACC; o resultado volta
+// no ACC. Aritmética de 16 bits; a divisão trunca para zero e o resto tem
+// o sinal do dividendo, como em C. Divisão por zero não para o programa,
+// mas o resultado não tem significado.
+enum class BipRoutine : unsigned char {
+    Mul,        // __MUL    ACC = __RT_A * ACC
+    Div,        // __DIV    ACC = __RT_A / ACC
+    Mod,        // __MOD    ACC = __RT_A % ACC
+    DivMod      // __DIVMOD __RT_Q = quociente, __RT_R = resto (usada por Div/Mod)
+};
+
+constexpr int kBipRoutineCount = 4;
+
+constexpr unsigned bipRoutineBit(BipRoutine r) { return 1u << static_cast<int>(r); }
+
+const char* bipRoutineLabel(BipRoutine r);
+
+// Assembly da rotina, uma linha por instrução ("ROTULO:" para rótulos),
+// no formato aceito por CodeGeneratorBIP::emitInstr
+const std::vector<std::string_view>& bipRoutineCode(BipRoutine r);
+
+// Rotinas chamadas por r (máscara de bipRoutineBit)
+unsigned bipRoutineDeps(BipRoutine r);
+
+// Variáveis de trabalho da biblioteca (todas começam em 0 na .data)
+const std::vector<std::string_view>& bipRuntimeData();
+
+#endif // BIPRUNTIME_H
@@ -0,0 +1,766 @@
+#include "bipvm.h"
+#include "bipjit.h"
+#include "bipperfil.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <unordered_map>
+
+namespace {
+
+std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t')) s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+    return s;
+}
+
+bool parseInt(std::string_view s, long& v) {
+    if (s.empty()) return false;
+    std::size_t i = (s[0] == '-' || s[0] == '+') ? 1 : 0;
+    if (i == s.size()) return false;
+    for (std::size_t k = i; k < s.size(); ++k)
+        if (s[k] < '0' || s[k] > '9') return false;
+    v = std::strtol(std::string(s).c_str(), nullptr, 10);
+    return true;
+}
+
+inline int16_t wrap16(long v) { return static_cast<int16_t>(static_cast<uint16_t>(v)); }
+
+// operando de memória: LD/STO/ADD..., e LDV/STOV (base do vetor)
+bool usaMemoria(BipOp op) {
+    switch (op) {
+    case BipOp::LD:  case BipOp::STO: case BipOp::LDV: case BipOp::STOV:
+    case BipOp::ADD: case BipOp::SUB: case BipOp::MUL: case BipOp::DIV: case BipOp::MOD:
+    case BipOp::AND: case BipOp::OR:  case BipOp::XOR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+class Montador {
+public:
+    Montador(BipImage& img, std::string& erro) : img_(img), erro_(erro) { }
+
+    bool montar(std::string_view texto);
+
+private:
+    bool falha(const std::string& msg) {
+        erro_ = "linha " + std::to_string(linha_) + ": " + msg;
+        return false;
+    }
+    int  variavel(std::string_view nome, int tamanho);   // endereço (cria se preciso)
+    bool dado(std::string_view s);
+    bool instrucao(std::string_view s);
+
+    BipImage&    img_;
+    std::string& erro_;
+    int          linha_ = 0;
+
+    std::unordered_map<std::string, int> varDe_;     // nome -> índice em img_.vars
+    std::unordered_map<std::string, int> rotuloDe_;  // nome -> pc
+    struct Pendente { std::size_t instr; std::string rotulo; int linha; };
+    std::vector<Pendente> pendentes_;
+};
+
+int Montador::variavel(std::string_view nome, int tamanho) {
+    const std::string chave(nome);
+    auto it = varDe_.find(chave);
+    if (it != varDe_.end()) return img_.vars[it->second].endereco;
+    BipVmVar v;
+    v.nome     = chave;
+    v.endereco = static_cast<int>(img_.dados.size());
+    v.tamanho  = tamanho;
+    img_.dados.resize(img_.dados.size() + tamanho, 0);
+    varDe_.emplace(chave, static_cast<int>(img_.vars.size()));
+    img_.vars.push_back(v);
+    return v.endereco;
+}
+
+// "nome : v1, v2, ..."
+bool Montador::dado(std::string_view s) {
+    const std::size_t dp = s.find(':');
+    if (dp == std::string_view::npos) return falha("dado sem ':'");
+    const std::string_view nome = trim(s.substr(0, dp));
+    if (nome.empty()) return falha("dado sem nome");
+    if (varDe_.count(std::string(nome))) return falha("dado repetido: " + std::string(nome));
+
+    std::vector<int16_t> valores;
+    std::string_view resto = s.substr(dp + 1);
+    while (true) {
+        const std::size_t vg = resto.find(',');
+        long v = 0;
+        if (!parseInt(trim(resto.substr(0, vg)), v))
+            return falha("valor inválido em " + std::string(nome));
+        valores.push_back(wrap16(v));
+        if (vg == std::string_view::npos) break;
+        resto = resto.substr(vg + 1);
+    }
+    const int end = variavel(nome, static_cast<int>(valores.size()));
+    std::copy(valores.begin(), valores.end(), img_.dados.begin() + end);
+    return true;
+}
+
+bool Montador::instrucao(std::string_view s) {
+    const std::size_t sp = s.find_first_of(" \t");
+    BipOp op;
+    if (!bipParseMnemonic(s.substr(0, sp), op))
+        return falha("instrução desconhecida: " + std::string(s.substr(0, sp)));
+
+    BipVmInstr in;
+    in.op = op;
+    const std::string_view arg = sp == std::string_view::npos ? std::string_view() : trim(s.substr(sp));
+    long v = 0;
+    if (bipIsJump(op)) {
+        if (arg.empty()) return falha("desvio sem destino");
+        in.modo = BipModo::Codigo;
+        pendentes_.push_back({ img_.codigo.size(), std::string(arg), linha_ });
+    } else if (arg.empty()) {
+        in.modo = BipModo::Nenhum;
+    } else if (parseInt(arg, v)) {
+        // LD 5 = endereço 5; LDI 5 / ADDI 5 / SLL 5 = valor
+        in.modo = usaMemoria(op) ? BipModo::Memoria : BipModo::Imediato;
+        in.arg  = usaMemoria(op) ? static_cast<int32_t>(v) : wrap16(v);
+    } else if (arg == "$indr") {
+        in.modo = BipModo::Indr;
+    } else if (arg == "$in_port") {
+        in.modo = BipModo::Entrada;
+    } else if (arg == "$out_port") {
+        in.modo = BipModo::Saida;
+    } else {
+        if (!usaMemoria(op)) return falha("operando inválido para " + std::string(bipMnemonic(op)));
+        in.modo = BipModo::Memoria;
+        in.arg  = variavel(arg, 1);
+    }
+    if ((op == BipOp::LDV || op == BipOp::STOV) && in.modo != BipModo::Memoria)
+        return falha(std::string(bipMnemonic(op)) + " precisa de um vetor");
+
+    img_.codigo.push_back(in);
+    img_.linha.push_back(linha_);
+    return true;
+}
+
+bool Montador::montar(std::string_view texto) {
+    img_ = BipImage();
+    enum { Fora, Dados, Texto } secao = Fora;
+
+    while (!texto.empty()) {
+        ++linha_;
+        const std::size_t nl = texto.find('\n');
+        std::string_view s = texto.substr(0, nl);
+        texto = nl == std::string_view::npos ? std::string_view() : texto.substr(nl + 1);
+
+        const std::size_t com = s.find(';');
+        if (com != std::string_view::npos) s = s.substr(0, com);
+        s = trim(s);
+        if (s.empty()) continue;
+        if (s == ".data") { secao = Dados; continue; }
+        if (s == ".text") { secao = Texto; continue; }
+
+        if (secao == Dados) {
+            if (!dado(s)) return false;
+            continue;
+        }
+        if (secao == Fora) return falha("fora de .data/.text");
+
+        // "ROTULO:" (com ou sem instrução depois)
+        const std::size_t dp = s.find(':');
+        if (dp != std::string_view::npos) {
+            const std::string nome(trim(s.substr(0, dp)));
+            if (!rotuloDe_.emplace(nome, static_cast<int>(img_.codigo.size())).second)
+                return falha("rótulo repetido: " + nome);
+            img_.rotulos.push_back({ nome, static_cast<int>(img_.codigo.size()) });
+            s = trim(s.substr(dp + 1));
+            if (s.empty()) continue;
+        }
+        if (!instrucao(s)) return false;
+    }
+
+    for (const Pendente& p : pendentes_) {
+        auto it = rotuloDe_.find(p.rotulo);
+        if (it == rotuloDe_.end()) {
+            linha_ = p.linha;
+            return falha("rótulo não definido: " + p.rotulo);
+        }
+        img_.codigo[p.instr].arg = it->second;
+    }
+
+    // tamanho do vetor de cada LDV/STOV, e endereços absolutos dentro da memória
+    std::vector<int> tamanhoEm(img_.dados.size(), 0);
+    for (const BipVmVar& v : img_.vars)
+        tamanhoEm[v.endereco] = v.tamanho;
+    for (std::size_t i = 0; i < img_.codigo.size(); ++i) {
+        BipVmInstr& in = img_.codigo[i];
+        if (in.modo != BipModo::Memoria) continue;
+        if (in.arg < 0 || in.arg >= static_cast<int32_t>(img_.dados.size())) {
+            linha_ = img_.linha[i];
+            return falha("endereço fora da memória de dados");
+        }
+        in.tam = (in.op == BipOp::LDV || in.op == BipOp::STOV) ? tamanhoEm[in.arg] : 1;
+    }
+
+    auto ent = rotuloDe_.find("_PRINCIPAL");
+    img_.entrada = ent != rotuloDe_.end() ? ent->second : 0;
+    return true;
+}
+
+} // namespace
+
+bool bipAssemble(std::string_view texto, BipImage& img, std::string& erro) {
+    Montador m(img, erro);
+    return m.montar(texto);
+}
+
+int bipCycles(BipOp op, bool desviou) {
+    if (op == BipOp::CALL || op == BipOp::RETURN) return 2;
+    return desviou ? 2 : 1;
+}
+
+const char* bipFimTexto(ResultadoExecucao::Fim fim) {
+    switch (fim) {
+    case ResultadoExecucao::Fim::Retorno:        return "retorno de main";
+    case ResultadoExecucao::Fim::Hlt:            return "HLT";
+    case ResultadoExecucao::Fim::FimDoCodigo:    return "fim do código";
+    case ResultadoExecucao::Fim::Limite:         return "limite de instruções";
+    case ResultadoExecucao::Fim::ErroIndice:     return "índice fora do vetor";
+    case ResultadoExecucao::Fim::ErroPilha:      return "pilha de chamadas cheia";
+    case ResultadoExecucao::Fim::DivisaoPorZero: return "divisão por zero";
+    }
+    return "";
+}
+
+BipVm::BipVm(const BipImage& img, Despacho d) : img_(img), despacho_(d) {
+    // sem JIT cai no Threaded, e sem computed goto no Switch
+    if (despacho_ == Despacho::Jit) {
+        jit_ = jitDisponivel() ? BipJitCodigo::compila(img_) : nullptr;
+        if (!jit_) despacho_ = Despacho::Threaded;
+    }
+    if (despacho_ == Despacho::Threaded && !threadedDisponivel())
+        despacho_ = Despacho::Switch;
+    if (despacho_ == Despacho::Threaded)
+        preDecodifica();
+}
+
+bool BipVm::threadedDisponivel() {
+#if defined(__GNUC__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+ResultadoExecucao BipVm::run(const std::vector<int>& entrada, const Limites& lim) const {
+    if (despacho_ == Despacho::Jit)
+        return runJit(entrada, lim);
+#if defined(__GNUC__)
+    if (despacho_ == Despacho::Threaded)
+        return runThreaded(entrada, lim);
+#endif
+    return runSwitch(entrada, lim);
+}
+
+ResultadoExecucao BipVm::run(const std::vector<int>& entrada, const Limites& lim,
+                             BipPerfil& perfil) const {
+    perfil.reinicia(img_.codigo.size());
+    return runSwitch(entrada, lim, &perfil);
+}
+
+ResultadoExecucao BipVm::runSwitch(const std::vector<int>& entrada, const Limites& lim,
+                                   BipPerfil* perfil) const {
+    ResultadoExecucao r;
+    Estado e;
+    e.mem = img_.dados;
+    e.pc  = img_.entrada;
+    interpreta(e, r, entrada, lim, UINT64_MAX, perfil);
+    r.acc = e.acc;
+    r.pc  = e.pc;
+    return r;
+}
+
+void BipVm::interpreta(Estado& e, ResultadoExecucao& r, const std::vector<int>& entrada,
+                       const Limites& lim, uint64_t passos, BipPerfil* perfil) const {
+    using Fim = ResultadoExecucao::Fim;
+
+    std::vector<int16_t>& mem = e.mem;
+    const BipVmInstr* const cod = img_.codigo.data();
+    const int n = static_cast<int>(img_.codigo.size());
+
+    int16_t acc = e.acc, status = e.status, indr = e.indr;
+    int pc = e.pc;
+
+    auto le = [&](const BipVmInstr& in) -> int16_t {
+        switch (in.modo) {
+        case BipModo::Imediato: return static_cast<int16_t>(in.arg);
+        case BipModo::Memoria:  return mem[in.arg];
+        case BipModo::Indr:     return indr;
+        case BipModo::Entrada:  return e.lidos < entrada.size() ? wrap16(entrada[e.lidos++]) : 0;
+        default:                return 0;
+        }
+    };
+    auto grava = [&](const BipVmInstr& in, int16_t v) {
+        switch (in.modo) {
+        case BipModo::Memoria: mem[in.arg] = v;       break;
+        case BipModo::Indr:    indr = v;              break;
+        case BipModo::Saida:   r.saida.push_back(v);  break;
+        default:                                      break;
+        }
+    };
+    auto ula = [&](long v) { acc = wrap16(v); status = acc; };
+    auto para = [&](Fim f) { r.fim = f; e.rodando = false; };
+
+    // a instrução que para a execução também conta
+    for (; e.rodando && passos > 0; --passos) {
+        if (pc < 0 || pc >= n) { para(Fim::FimDoCodigo); break; }
+        if (lim.instrucoes && r.instrucoes >= lim.instrucoes) { para(Fim::Limite); break; }
+        const BipVmInstr& in = cod[pc];
+        ++r.instrucoes;
+        bool desviou = false;
+        int  prox = pc + 1;
+
+        switch (in.op) {
+        case BipOp::LD:   acc = le(in);        break;
+        case BipOp::LDI:  acc = static_cast<int16_t>(in.arg); break;
+        case BipOp::STO:  grava(in, acc);      break;
+        case BipOp::LDV:
+        case BipOp::STOV:
+            if (indr < 0 || indr >= in.tam) { para(Fim::ErroIndice); break; }
+            if (in.op == BipOp::LDV) acc = mem[in.arg + indr];
+            else                     mem[in.arg + indr] = acc;
+            break;
+
+        case BipOp::ADD: case BipOp::ADDI: ula(long(acc) + le(in)); break;
+        case BipOp::SUB: case BipOp::SUBI: ula(long(acc) - le(in)); break;
+        case BipOp::MUL: case BipOp::MULI: ula(long(acc) * le(in)); break;
+        case BipOp::DIV: case BipOp::DIVI:
+        case BipOp::MOD: case BipOp::MODI: {
+            const long b = le(in);
+            if (b == 0) { para(Fim::DivisaoPorZero); break; }
+            const bool div = in.op == BipOp::DIV || in.op == BipOp::DIVI;
+            ula(div ? long(acc) / b : long(acc) % b);
+            break;
+        }
+        case BipOp::AND: case BipOp::ANDI: ula(acc & le(in)); break;
+        case BipOp::OR:  case BipOp::ORI:  ula(acc | le(in)); break;
+        case BipOp::XOR: case BipOp::XORI: ula(acc ^ le(in)); break;
+        case BipOp::NOT: ula(~acc); break;
+        case BipOp::SLL: case BipOp::SHL:
+        case BipOp::SRL: case BipOp::SHR: {
+            const long k = in.modo == BipModo::Nenhum ? 1 : le(in);
+            const uint16_t u = static_cast<uint16_t>(acc);
+            const bool esq = in.op == BipOp::SLL || in.op == BipOp::SHL;
+            ula(k < 0 || k > 15 ? 0 : esq ? long(u) << k : long(u) >> k);
+            break;
+        }
+
+        case BipOp::JMP: desviou = true;          break;
+        case BipOp::JZ:  desviou = acc == 0;      break;
+        case BipOp::BEQ: desviou = status == 0;   break;
+        case BipOp::BNE: desviou = status != 0;   break;
+        case BipOp::BGT: desviou = status >  0;   break;
+        case BipOp::BGE: desviou = status >= 0;   break;
+        case BipOp::BLT: desviou = status <  0;   break;
+        case BipOp::BLE: desviou = status <= 0;   break;
+
+        case BipOp::CALL:
+            if (e.prof >= lim.pilha) { para(Fim::ErroPilha); break; }
+            if (e.prof >= static_cast<int>(e.pilha.size())) e.pilha.resize(e.prof + 1);
+            e.pilha[e.prof++] = prox;
+            desviou = true;
+            break;
+        case BipOp::RETURN:
+            if (e.prof == 0) { para(Fim::Retorno); break; }
+            prox = e.pilha[--e.prof];
+            break;
+        case BipOp::HLT:
+            para(Fim::Hlt);
+            break;
+
+        default:        // Label/Raw nunca saem do montador
+            break;
+        }
+
+        const int ciclos = bipCycles(in.op, desviou);
+        r.ciclos += ciclos;
+        if (perfil) {
+            // o CALL é do chamador, o RETURN do chamado
+            perfil->conta(pc, ciclos);
+            if (e.rodando && in.op == BipOp::CALL)   perfil->entra(in.arg);
+            if (e.rodando && in.op == BipOp::RETURN) perfil->sai();
+        }
+        if (e.rodando) pc = desviou ? in.arg : prox;
+    }
+
+    e.acc = acc;
+    e.status = status;
+    e.indr = indr;
+    e.pc = pc;
+}
+
+#if defined(__GNUC__)
+
+// =================== Threaded ===================
+
+namespace {
+
+// índices na tabela de tratadores de runThreaded (mesma ordem)
+enum Tratador {
+    T_LD, T_LD_IN, T_STO, T_STO_OUT, T_NOP, T_LDV, T_STOV,
+    T_ADD, T_SUB, T_MUL, T_DIV, T_MOD, T_AND, T_OR, T_XOR, T_NOT, T_SLL, T_SRL,
+    T_ULA_IN,
+    T_JMP, T_JZ, T_BCC, T_CALL, T_RETURN, T_HLT, T_FIM,
+    // superinstruções
+    T_LD_STO, T_LD_ADD, T_LD_SUB, T_ADD_STO, T_SUB_STO, T_LD_STOV, T_IDX_LDV, T_SUB_BCC,
+    T_TOTAL
+};
+
+int tratadorUla(BipOp op) {
+    switch (op) {
+    case BipOp::ADD: case BipOp::ADDI: return T_ADD;
+    case BipOp::SUB: case BipOp::SUBI: return T_SUB;
+    case BipOp::MUL: case BipOp::MULI: return T_MUL;
+    case BipOp::DIV: case BipOp::DIVI: return T_DIV;
+    case BipOp::MOD: case BipOp::MODI: return T_MOD;
+    case BipOp::AND: case BipOp::ANDI: return T_AND;
+    case BipOp::OR:  case BipOp::ORI:  return T_OR;
+    case BipOp::XOR: case BipOp::XORI: return T_XOR;
+    case BipOp::SLL: case BipOp::SHL:  return T_SLL;
+    case BipOp::SRL: case BipOp::SHR:  return T_SRL;
+    default:                           return -1;
+    }
+}
+
+// BEQ..BLE: bits de STATUS aceitos (1 = negativo, 2 = zero, 4 = positivo)
+int mascaraDesvio(BipOp op) {
+    switch (op) {
+    case BipOp::BEQ: return 2;
+    case BipOp::BNE: return 5;
+    case BipOp::BGT: return 4;
+    case BipOp::BGE: return 6;
+    case BipOp::BLT: return 1;
+    case BipOp::BLE: return 3;
+    default:         return 0;
+    }
+}
+
+} // namespace
+
+void BipVm::preDecodifica() {
+    const void* const* tab = nullptr;
+    runThreaded({}, Limites(), &tab);
+
+    const std::vector<BipVmInstr>& cod = img_.codigo;
+    const int n = static_cast<int>(cod.size());
+
+    // memória: .data | $indr | zero | rascunho da entrada | constantes
+    memoria_ = img_.dados;
+    indr_ = static_cast<int>(memoria_.size());
+    const int zero     = indr_ + 1;
+    const int rascunho = indr_ + 2;
+    memoria_.resize(memoria_.size() + 3, 0);
+    std::unordered_map<int, int> constDe;
+    auto constante = [&](int v) {
+        const int16_t k = wrap16(v);
+        auto it = constDe.find(k);
+        if (it != constDe.end()) return it->second;
+        const int end = static_cast<int>(memoria_.size());
+        memoria_.push_back(k);
+        constDe.emplace(k, end);
+        return end;
+    };
+    // posição lida pelo operando; -1 = $in_port (tem tratador próprio)
+    auto fonte = [&](const BipVmInstr& in) {
+        switch (in.modo) {
+        case BipModo::Imediato: return constante(in.arg);
+        case BipModo::Memoria:  return static_cast<int>(in.arg);
+        case BipModo::Indr:     return indr_;
+        case BipModo::Entrada:  return -1;
+        default:                return zero;
+        }
+    };
+    // posição escrita por STO; -1 = nenhuma ($in_port etc.)
+    auto destino = [&](const BipVmInstr& in) {
+        switch (in.modo) {
+        case BipModo::Memoria: return static_cast<int>(in.arg);
+        case BipModo::Indr:    return indr_;
+        default:               return -1;
+        }
+    };
+    auto leitura = [&](const BipVmInstr& in) {   // LD/LDI que cabe numa superinstrução
+        return in.op == BipOp::LDI || (in.op == BipOp::LD && in.modo != BipModo::Entrada);
+    };
+    auto somaOuSub = [&](const BipVmInstr& in, bool sub) {
+        const bool op = sub ? (in.op == BipOp::SUB || in.op == BipOp::SUBI)
+                            : (in.op == BipOp::ADD || in.op == BipOp::ADDI);
+        return op && in.modo != BipModo::Entrada;
+    };
+    auto lido = [&](const BipVmInstr& in) {      // posição lida por leitura()/somaOuSub()
+        return in.op == BipOp::LDI ? constante(in.arg) : fonte(in);
+    };
+
+    // rótulos de fato usados: uma superinstrução não pode ter um no meio
+    std::vector<char> alvo(n + 1, 0);
+    alvo[std::min(std::max(img_.entrada, 0), n)] = 1;
+    for (const BipVmInstr& in : cod)
+        if (in.modo == BipModo::Codigo && in.arg >= 0 && in.arg <= n) alvo[in.arg] = 1;
+
+    auto celula = [&](int t, int a, int b, int c, int k) {
+        Celula cel;
+        cel.h = tab[t];
+        cel.a = a;
+        cel.b = b;
+        cel.c = c;
+        cel.n = k;
+        return cel;
+    };
+
+    std::vector<int> celDe(n + 1, 0);            // instrução (início de célula) -> célula
+    celulas_.clear();
+    origem_.clear();
+    for (int i = 0; i < n; ) {
+        const BipVmInstr& in = cod[i];
+        const bool cabe2 = i + 1 < n && !alvo[i + 1];
+        const bool cabe3 = cabe2 && i + 2 < n && !alvo[i + 2];
+        const BipVmInstr* s1 = cabe2 ? &cod[i + 1] : nullptr;
+        const BipVmInstr* s2 = cabe3 ? &cod[i + 2] : nullptr;
+        const bool stoMem = s1 && s1->op == BipOp::STO && destino(*s1) >= 0;
+        Celula cel;
+
+        if (s2 && leitura(in) && s1->op == BipOp::STO && s1->modo == BipModo::Indr && s2->op == BipOp::LDV) {
+            cel = celula(T_IDX_LDV, lido(in), s2->arg, s2->tam, 3);
+        } else if (s1 && leitura(in) && s1->op == BipOp::STOV) {
+            cel = celula(T_LD_STOV, lido(in), s1->arg, s1->tam, 2);
+        } else if (leitura(in) && stoMem) {
+            cel = celula(T_LD_STO, lido(in), destino(*s1), 0, 2);
+        } else if (s1 && leitura(in) && (somaOuSub(*s1, false) || somaOuSub(*s1, true))) {
+            cel = celula(somaOuSub(*s1, true) ? T_LD_SUB : T_LD_ADD, lido(in), lido(*s1), 0, 2);
+        } else if (stoMem && (somaOuSub(in, false) || somaOuSub(in, true))) {
+            cel = celula(somaOuSub(in, true) ? T_SUB_STO : T_ADD_STO, lido(in), destino(*s1), 0, 2);
+        } else if (s1 && somaOuSub(in, true) && mascaraDesvio(s1->op)) {
+            cel = celula(T_SUB_BCC, lido(in), s1->arg, mascaraDesvio(s1->op), 2);
+        } else {
+            const int t = tratadorUla(in.op);
+            switch (in.op) {
+            case BipOp::LD:
+                cel = in.modo == BipModo::Entrada ? celula(T_LD_IN, 0, 0, 0, 1) : celula(T_LD, fonte(in), 0, 0, 1);
+                break;
+            case BipOp::LDI:
+                cel = celula(T_LD, constante(in.arg), 0, 0, 1);
+                break;
+            case BipOp::STO:
+                cel = destino(in) >= 0           ? celula(T_STO, destino(in), 0, 0, 1)
+                    : in.modo == BipModo::Saida ? celula(T_STO_OUT, 0, 0, 0, 1)
+                                                : celula(T_NOP, 0, 0, 0, 1);
+                break;
+            case BipOp::LDV:  cel = celula(T_LDV, 0, in.arg, in.tam, 1);  break;
+            case BipOp::STOV: cel = celula(T_STOV, 0, in.arg, in.tam, 1); break;
+            case BipOp::NOT:  cel = celula(T_NOT, 0, 0, 0, 1);            break;
+            case BipOp::JMP:  cel = celula(T_JMP, in.arg, 0, 0, 1);       break;
+            case BipOp::JZ:   cel = celula(T_JZ, in.arg, 0, 0, 1);        break;
+            case BipOp::CALL: cel = celula(T_CALL, in.arg, 0, 0, 1);      break;
+            case BipOp::RETURN: cel = celula(T_RETURN, 0, 0, 0, 1);       break;
+            case BipOp::HLT:  cel = celula(T_HLT, 0, 0, 0, 1);            break;
+            default:
+                if (mascaraDesvio(in.op)) {
+                    cel = celula(T_BCC, in.arg, 0, mascaraDesvio(in.op), 1);
+                } else if (t >= 0) {
+                    // SLL/SRL sem operando deslocam 1
+                    const bool desloca = t == T_SLL || t == T_SRL;
+                    const int  a = desloca && in.modo == BipModo::Nenhum ? constante(1) : fonte(in);
+                    cel = a < 0 ? celula(T_ULA_IN, rascunho, 0, t, 1) : celula(t, a, 0, 0, 1);
+                } else {
+                    cel = celula(T_NOP, 0, 0, 0, 1);    // Label/Raw nunca saem do montador
+                }
+                break;
+            }
+        }
+        celDe[i] = static_cast<int>(celulas_.size());
+        celulas_.push_back(cel);
+        origem_.push_back(i);
+        i += cel.n;
+    }
+    celDe[n] = static_cast<int>(celulas_.size());
+    celulas_.push_back(celula(T_FIM, 0, 0, 0, 0));
+    origem_.push_back(n);
+
+    // destinos: instrução -> célula (todo alvo começa uma célula)
+    for (Celula& cel : celulas_) {
+        if (cel.h == tab[T_JMP] || cel.h == tab[T_JZ] || cel.h == tab[T_BCC] || cel.h == tab[T_CALL])
+            cel.a = celDe[cel.a];
+        else if (cel.h == tab[T_SUB_BCC])
+            cel.b = celDe[cel.b];
+    }
+}
+
+ResultadoExecucao BipVm::runThreaded(const std::vector<int>& entrada, const Limites& lim,
+                                     const void* const** tabela) const {
+    using Fim = ResultadoExecucao::Fim;
+    static const void* const tab[T_TOTAL] = {
+        &&h_ld, &&h_ld_in, &&h_sto, &&h_sto_out, &&h_nop, &&h_ldv, &&h_stov,
+        &&h_add, &&h_sub, &&h_mul, &&h_div, &&h_mod, &&h_and, &&h_or, &&h_xor, &&h_not, &&h_sll, &&h_srl,
+        &&h_ula_in,
+        &&h_jmp, &&h_jz, &&h_bcc, &&h_call, &&h_return, &&h_hlt, &&h_fim,
+        &&h_ld_sto, &&h_ld_add, &&h_ld_sub, &&h_add_sto, &&h_sub_sto, &&h_ld_stov, &&h_idx_ldv, &&h_sub_bcc
+    };
+    ResultadoExecucao r;
+    if (tabela) {
+        *tabela = tab;
+        return r;
+    }
+
+    std::vector<int16_t>       memoria = memoria_;
+    std::vector<const Celula*> pilha;
+    int16_t* const      m    = memoria.data();
+    const Celula* const cel  = celulas_.data();
+    const int           ix   = indr_;
+    const std::size_t   maxPilha = static_cast<std::size_t>(std::max(lim.pilha, 0));
+    std::size_t lidos = 0;
+
+    // orçamento de instruções: cada despacho desconta as da célula
+    const int64_t total = lim.instrucoes && lim.instrucoes < uint64_t(INT64_MAX)
+                        ? static_cast<int64_t>(lim.instrucoes) : INT64_MAX;
+    int64_t  orc   = total;
+    uint64_t extra = 0;            // ciclos além de 1 por instrução
+    int16_t  acc = 0, status = 0;
+    const Celula* pc = cel + (std::lower_bound(origem_.begin(), origem_.end(), img_.entrada) - origem_.begin());
+
+#define BIPVM_DESPACHA() do { if ((orc -= pc->n) < 0) goto limite; goto *pc->h; } while (0)
+#define BIPVM_PROXIMA()  do { ++pc; BIPVM_DESPACHA(); } while (0)
+#define BIPVM_DESVIA(d)  do { ++extra; pc = cel + (d); BIPVM_DESPACHA(); } while (0)
+#define BIPVM_ULA(v)     (status = acc = wrap16(v))
+#define BIPVM_ENTRA()    (lidos < entrada.size() ? wrap16(entrada[lidos++]) : int16_t(0))
+#define BIPVM_BITS()     (status < 0 ? 1 : status == 0 ? 2 : 4)
+
+    BIPVM_DESPACHA();
+
+h_ld:      acc = m[pc->a];                        BIPVM_PROXIMA();
+h_ld_in:   acc = BIPVM_ENTRA();                   BIPVM_PROXIMA();
+h_sto:     m[pc->a] = acc;                        BIPVM_PROXIMA();
+h_sto_out: r.saida.push_back(acc);                BIPVM_PROXIMA();
+h_nop:                                            BIPVM_PROXIMA();
+h_ldv: {
+    const int i = m[ix];
+    if (i < 0 || i >= pc->c) goto erroIndice;
+    acc = m[pc->b + i];
+    BIPVM_PROXIMA();
+}
+h_stov: {
+    const int i = m[ix];
+    if (i < 0 || i >= pc->c) goto erroIndice;
+    m[pc->b + i] = acc;
+    BIPVM_PROXIMA();
+}
+
+h_add: BIPVM_ULA(long(acc) + m[pc->a]); BIPVM_PROXIMA();
+h_sub: BIPVM_ULA(long(acc) - m[pc->a]); BIPVM_PROXIMA();
+h_mul: BIPVM_ULA(long(acc) * m[pc->a]); BIPVM_PROXIMA();
+h_div: {
+    const long b = m[pc->a];
+    if (b == 0) goto divisao;
+    BIPVM_ULA(long(acc) / b);
+    BIPVM_PROXIMA();
+}
+h_mod: {
+    const long b = m[pc->a];
+    if (b == 0) goto divisao;
+    BIPVM_ULA(long(acc) % b);
+    BIPVM_PROXIMA();
+}
+h_and: BIPVM_ULA(acc & m[pc->a]); BIPVM_PROXIMA();
+h_or:  BIPVM_ULA(acc | m[pc->a]); BIPVM_PROXIMA();
+h_xor: BIPVM_ULA(acc ^ m[pc->a]); BIPVM_PROXIMA();
+h_not: BIPVM_ULA(~acc);           BIPVM_PROXIMA();
+h_sll: {
+    const long k = m[pc->a];
+    BIPVM_ULA(k < 0 || k > 15 ? 0 : long(static_cast<uint16_t>(acc)) << k);
+    BIPVM_PROXIMA();
+}
+h_srl: {
+    const long k = m[pc->a];
+    BIPVM_ULA(k < 0 || k > 15 ? 0 : long(static_cast<uint16_t>(acc)) >> k);
+    BIPVM_PROXIMA();
+}
+h_ula_in:   // operando $in_port: lê para o rascunho e segue no tratador da operação
+    m[pc->a] = BIPVM_ENTRA();
+    goto *tab[pc->c];
+
+h_jmp: BIPVM_DESVIA(pc->a);
+h_jz:
+    if (acc == 0) BIPVM_DESVIA(pc->a);
+    BIPVM_PROXIMA();
+h_bcc:
+    if (pc->c & BIPVM_BITS()) BIPVM_DESVIA(pc->a);
+    BIPVM_PROXIMA();
+h_call:
+    if (pilha.size() >= maxPilha) { ++extra; goto erroPilha; }
+    pilha.push_back(pc + 1);
+    BIPVM_DESVIA(pc->a);
+h_return:
+    ++extra;
+    if (pilha.empty()) { r.fim = Fim::Retorno; goto para; }
+    pc = pilha.back();
+    pilha.pop_back();
+    BIPVM_DESPACHA();
+h_hlt:
+    r.fim = Fim::Hlt;
+    goto para;
+h_fim:
+    r.fim = Fim::FimDoCodigo;
+    r.pc  = origem_[pc - cel];
+    goto fim;
+
+h_ld_sto:  acc = m[pc->a]; m[pc->b] = acc;                  BIPVM_PROXIMA();
+h_ld_add:  acc = m[pc->a]; BIPVM_ULA(long(acc) + m[pc->b]); BIPVM_PROXIMA();
+h_ld_sub:  acc = m[pc->a]; BIPVM_ULA(long(acc) - m[pc->b]); BIPVM_PROXIMA();
+h_add_sto: BIPVM_ULA(long(acc) + m[pc->a]); m[pc->b] = acc; BIPVM_PROXIMA();
+h_sub_sto: BIPVM_ULA(long(acc) - m[pc->a]); m[pc->b] = acc; BIPVM_PROXIMA();
+h_ld_stov: {
+    acc = m[pc->a];
+    const int i = m[ix];
+    if (i < 0 || i >= pc->c) goto erroIndice;
+    m[pc->b + i] = acc;
+    BIPVM_PROXIMA();
+}
+h_idx_ldv: {
+    acc = m[pc->a];
+    m[ix] = acc;
+    const int i = acc;
+    if (i < 0 || i >= pc->c) goto erroIndice;
+    acc = m[pc->b + i];
+    BIPVM_PROXIMA();
+}
+h_sub_bcc:
+    BIPVM_ULA(long(acc) - m[pc->a]);
+    if (pc->c & BIPVM_BITS()) BIPVM_DESVIA(pc->b);
+    BIPVM_PROXIMA();
+
+#undef BIPVM_DESPACHA
+#undef BIPVM_PROXIMA
+#undef BIPVM_DESVIA
+#undef BIPVM_ULA
+#undef BIPVM_ENTRA
+#undef BIPVM_BITS
+
+limite:         // a célula não executou: devolve o que ela descontou
+    orc += pc->n;
+    r.fim = Fim::Limite;
+    r.pc  = origem_[pc - cel];
+    goto fim;
+erroIndice:
+    r.fim = Fim::ErroIndice;
+    goto para;
+erroPilha:
+    r.fim = Fim::ErroPilha;
+    goto para;
+divisao:
+    r.fim = Fim::DivisaoPorZero;
+    goto para;
+para:           // parou dentro da célula: na última instrução dela
+    r.pc = origem_[pc - cel] + pc->n - 1;
+fim:
+    r.instrucoes = static_cast<uint64_t>(total - orc);
+    r.ciclos     = r.instrucoes + extra;
+    r.acc        = acc;
+    return r;
+}
+
+#endif // __GNUC__
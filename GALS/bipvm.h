@@ -0,0 +1,175 @@
+#ifndef BIPVM_H
+#define BIPVM_H
+
+#include "bipir.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// =================== Máquina virtual da BIP ===================
+// Monta o texto de CodeGeneratorBIP::buildProgram (.data + .text) e o
+// executa no próprio processo, com $in_port/$out_port ligados a vetores.
+//
+// Semântica (a mesma que o gerador assume):
+//  - ACC, memória e $indr de 16 bits com sinal; toda escrita trunca;
+//  - as operações da ULA (ADD..XOR, NOT, SLL/SRL) copiam o resultado em
+//    STATUS; BEQ..BLE comparam STATUS com zero, JZ testa o próprio ACC;
+//  - LDV/STOV acessam vetor[$indr]; índice fora do vetor para a execução;
+//  - RETURN com a pilha vazia (o RETURN de main) termina o programa;
+//  - ler $in_port depois do fim da entrada dá 0.
+//
+// Ciclos: uma instrução custa 1 ciclo; desvio tomado, CALL e RETURN
+// custam 2 (a busca seguinte é descartada). Ver bipCycles.
+//
+// Dois interpretadores dão o mesmo resultado: Switch decodifica BipVmInstr
+// a cada passo (a referência); Threaded pré-decodifica o programa uma vez,
+// no construtor, em células com o endereço do tratador e os operandos já
+// resolvidos, e despacha com computed goto (GCC/Clang; nos outros
+// compiladores cai no Switch). Sequências frequentes do gerador viram uma
+// célula só (superinstruções), quando nenhum rótulo cai no meio delas.
+// Jit traduz os blocos básicos para x86-64 (bipjit.h) e devolve ao Switch
+// só as instruções de E/S, as que param a execução e o fim do orçamento.
+// Com um BipPerfil (bipperfil.h) a execução é sempre a do Switch, contando
+// cada instrução e os ciclos de cada cadeia de CALL.
+
+// onde está o operando de uma instrução montada
+enum class BipModo : unsigned char {
+    Nenhum,
+    Imediato,   // arg = valor
+    Memoria,    // arg = endereço na memória de dados
+    Indr,       // $indr
+    Entrada,    // $in_port
+    Saida,      // $out_port
+    Codigo      // arg = índice da instrução de destino
+};
+
+struct BipVmInstr {
+    BipOp   op   = BipOp::HLT;
+    BipModo modo = BipModo::Nenhum;
+    int32_t arg  = 0;
+    int32_t tam  = 0;     // LDV/STOV: tamanho do vetor em 'arg'
+};
+
+struct BipVmVar {
+    std::string nome;
+    int         endereco = 0;
+    int         tamanho  = 1;
+};
+
+struct BipVmRotulo {
+    std::string nome;
+    int         pc = 0;
+};
+
+// programa montado: imutável depois de bipAssemble, pode ser executado
+// por várias BipVm (inclusive em threads diferentes) ao mesmo tempo
+struct BipImage {
+    std::vector<BipVmInstr>  codigo;
+    std::vector<int>         linha;      // linha (1..) do texto de cada instrução
+    std::vector<int16_t>     dados;      // memória inicial
+    std::vector<BipVmVar>    vars;       // na ordem da .data (+ as implícitas)
+    std::vector<BipVmRotulo> rotulos;    // na ordem do .text
+    int                      entrada = 0;   // _PRINCIPAL, ou a primeira instrução
+};
+
+// Monta 'texto'. Comentários começam em ';'. Dado citado no .text sem
+// estar na .data ganha uma posição zerada (como o simulador da IDE faz).
+// Em erro devolve false e preenche 'erro' com a linha.
+bool bipAssemble(std::string_view texto, BipImage& img, std::string& erro);
+
+int bipCycles(BipOp op, bool desviou);
+
+struct ResultadoExecucao {
+    enum class Fim {
+        Retorno,        // RETURN de main
+        Hlt,
+        FimDoCodigo,    // PC passou da última instrução
+        Limite,         // atingiu o limite de instruções
+        ErroIndice,     // LDV/STOV fora do vetor
+        ErroPilha,      // CALL além da profundidade máxima
+        DivisaoPorZero  // DIV/MOD na própria máquina (a biblioteca não para)
+    };
+
+    Fim              fim = Fim::FimDoCodigo;
+    std::vector<int> saida;               // valores escritos em $out_port
+    uint64_t         instrucoes = 0;
+    uint64_t         ciclos     = 0;
+    int              acc        = 0;      // ao terminar (valor de retorno de main)
+    int              pc         = 0;      // instrução que parou a execução (erros)
+
+    bool ok() const { return fim == Fim::Retorno || fim == Fim::Hlt || fim == Fim::FimDoCodigo; }
+};
+
+const char* bipFimTexto(ResultadoExecucao::Fim fim);
+
+class BipJitCodigo;
+struct BipPerfil;
+
+class BipVm {
+public:
+    enum class Despacho { Switch, Threaded, Jit };
+
+    struct Limites {
+        uint64_t instrucoes = 100000000;  // 0 = sem limite (Threaded: pode parar até 2 antes)
+        int      pilha      = 1024;       // profundidade de CALL
+    };
+
+    explicit BipVm(const BipImage& img, Despacho d = Despacho::Threaded);
+
+    static bool threadedDisponivel();
+    static bool jitDisponivel();        // bipjit.cpp
+    Despacho despacho() const { return despacho_; }
+
+    ResultadoExecucao run(const std::vector<int>& entrada, const Limites& lim) const;
+    ResultadoExecucao run(const std::vector<int>& entrada) const { return run(entrada, Limites()); }
+    // perfilado (Switch, qualquer que seja o despacho); 'perfil' é zerado antes
+    ResultadoExecucao run(const std::vector<int>& entrada, const Limites& lim, BipPerfil& perfil) const;
+
+    // célula pré-decodificada (Threaded). A memória do Threaded é a .data
+    // seguida de $indr e das constantes, então LD/LDI, ADD/ADDI etc. usam
+    // o mesmo tratador e 'a'/'b' são só índices nela.
+    struct Celula {
+        const void* h = nullptr;   // tratador
+        int32_t     a = 0;         // operando
+        int32_t     b = 0;         // segundo operando / base do vetor / destino
+        int32_t     c = 0;         // tamanho do vetor / máscara da condição
+        int32_t     n = 1;         // instruções da BIP que a célula executa
+    };
+
+private:
+    // estado da máquina entre duas chamadas de interpreta (o JIT o retoma)
+    struct Estado {
+        std::vector<int16_t> mem;
+        std::vector<int>     pilha;      // endereços de retorno; cresce até lim.pilha
+        int                  prof  = 0;
+        int16_t              acc = 0, status = 0, indr = 0;
+        int                  pc    = 0;
+        std::size_t          lidos = 0;  // valores já lidos da entrada
+        bool                 rodando = true;
+    };
+
+    // executa até 'passos' instruções de 'e' (ou até parar), somando em 'r'
+    // (e em 'perfil', se houver)
+    void interpreta(Estado& e, ResultadoExecucao& r, const std::vector<int>& entrada,
+                    const Limites& lim, uint64_t passos, BipPerfil* perfil = nullptr) const;
+    ResultadoExecucao runSwitch(const std::vector<int>& entrada, const Limites& lim,
+                                BipPerfil* perfil = nullptr) const;
+    // com 'tabela' só devolve os endereços dos tratadores (para preDecodifica)
+    ResultadoExecucao runThreaded(const std::vector<int>& entrada, const Limites& lim,
+                                  const void* const** tabela = nullptr) const;
+    void preDecodifica();
+    ResultadoExecucao runJit(const std::vector<int>& entrada, const Limites& lim) const;   // bipjit.cpp
+
+    const BipImage&      img_;
+    Despacho             despacho_;
+    std::vector<Celula>  celulas_;     // + uma sentinela de fim do código
+    std::vector<int>     origem_;      // célula -> instrução da BIP
+    std::vector<int16_t> memoria_;     // memória inicial do Threaded
+    int                  indr_ = 0;    // índice de $indr em memoria_
+    std::shared_ptr<const BipJitCodigo> jit_;
+};
+
+#endif // BIPVM_H
@@ -1,6 +1,7 @@
-#include "CodeGeneratorBIP.h"
+#include "codegeneratorbip.h"
 #include <fstream>
 #include <algorithm>
+#include <cstdint>
 
 // =================== internos ===================
 static inline bool isIdentChar(unsigned char c) {
@@ -24,9 +25,19 @@ static bool isIntegerLiteral(const std::string& s) {
     return true;
 }
 
+// posição no fonte das instruções emitidas enquanto vive (mapa do fonte)
+namespace {
+struct PosFonte {
+    int& atual;
+    int  antes;
+    PosFonte(int& a, int pos) : atual(a), antes(a) { if (pos >= 0) atual = pos; }
+    ~PosFonte() { atual = antes; }
+};
+} // namespace
+
 // =================== ctor ===================
 CodeGeneratorBIP::CodeGeneratorBIP(const Options& opt)
-    : opt_(opt) {}
+    : opt_(opt) { clearText(); }
 
 // =================== helpers estáticos ===================
 std::string CodeGeneratorBIP::sanitizeLabel(const std::string& s) {
@@ -38,18 +49,18 @@ std::string CodeGeneratorBIP::sanitizeLabel(const std::string& s) {
 
 bool CodeGeneratorBIP::isGlobalDataCandidate(const Simbolo& s) {
     // NÃO entra em .data:
-    if (s.modalidade == "funcao" || s.modalidade == "parametro") {
+    if (s.modalidade == Modalidade::Funcao || s.modalidade == Modalidade::Parametro) {
         return false;
     }
 
     // ENTRA em .data:
     // - variáveis escalares
-    if (s.modalidade == "variavel") {
+    if (s.modalidade == Modalidade::Variavel) {
         return true;
     }
 
     // - vetores (se sua linguagem tiver)
-    if (s.modalidade == "vetor" || s.isVetor) {
+    if (s.modalidade == Modalidade::Vetor || s.isVetor) {
         return true;
     }
 
@@ -68,6 +79,13 @@ std::string CodeGeneratorBIP::buildDataSection(const std::vector<Simbolo>& tabel
                   [](const Simbolo* a, const Simbolo* b){ return a->nome < b->nome; });
     }
 
+    // sem referência no código final (deadCode): fica fora da .data
+    auto usado = [&](const std::string& label) {
+        if (dadoUsado_.empty()) return true;
+        const int id = dados_.buscar(label);
+        return id != Interner::NENHUM && dadoUsado_[id];
+    };
+
     std::ostringstream out;
     if (opt_.includeDataHeader) out << ".data\n";
 
@@ -81,8 +99,11 @@ std::string CodeGeneratorBIP::buildDataSection(const std::vector<Simbolo>& tabel
             label = sanitizeLabel(s.nome) + "_" + std::to_string(k++);
         }
         used.insert(label);
+        if (!usado(label)) continue;
 
-        bool ehVetor = (s.modalidade == "vetor" || s.isVetor);
+        // a AST registra tamanho/inicializadores de todo vetor declarado
+        bool ehVetor = (s.modalidade == Modalidade::Vetor || s.isVetor ||
+                        arraySizes_.count(label) || arrayInitialValues_.count(label));
 
         int N = 1;
         if (ehVetor) {
@@ -126,7 +147,20 @@ std::string CodeGeneratorBIP::buildDataSection(const std::vector<Simbolo>& tabel
         }
         out << "\n";
     }
-    out << "__TMP0 : 0\n";
+    for (int k = 0; k < tempCount_; ++k) {
+        const std::string temp = "__TMP" + std::to_string(k);
+        if (usado(temp)) out << temp << " : 0\n";
+    }
+    for (int d : invs_) {
+        const std::string inv(dados_.texto(d));
+        if (usado(inv)) out << inv << " : 0\n";
+    }
+    // variáveis da biblioteca (bipruntime.h), se alguma rotina entrou
+    for (std::string_view nome : bipRuntimeData()) {
+        const std::string dado(nome);
+        if (dados_.buscar(dado) != Interner::NENHUM && usado(dado))
+            out << dado << " : 0\n";
+    }
 
     out << "\n";
     return out.str();
@@ -153,15 +187,74 @@ bool CodeGeneratorBIP::emitDataToFile(const std::string& outPath,
 
 // =================== .text – API ===================
 void CodeGeneratorBIP::clearText() {
-    text_.clear();
+    code_.clear();
+    raw_.clear();
+    posFonte_     = -1;
     labelCounter_ = 0;
+    loopCounter_  = 0;
+    ifCounter_    = 0;
+    tempCount_    = 1;
+    funcoes_.clear();
+    currentFunction_ = nullptr;
+    labels_.clear();
+    temps_.clear();
+    tempsVirtuais_.clear();
+    tempVirtualDe_.clear();
+    consts_.clear();
+    sinteticos_.clear();
+    invs_.clear();
+    invCount_ = 0;
+    rotinas_  = 0;
+    linkadas_ = 0;
+    peephole_ = PeepholeStats();
+    dadoUsado_.clear();
+    rotulos_.clear();
+    dados_.clear();
+    indr_    = dados_.intern("$indr");
+    inPort_  = dados_.intern("$in_port");
+    outPort_ = dados_.intern("$out_port");
+}
+
+int CodeGeneratorBIP::dataId(const std::string& nome) {
+    return dados_.intern(sanitizeLabel(nome));
 }
 
-void CodeGeneratorBIP::emitInstr(const std::string& instr) { text_.push_back(instr); }
+int CodeGeneratorBIP::labelId(const std::string& nome) {
+    return rotulos_.intern(sanitizeLabel(nome));
+}
+
+int CodeGeneratorBIP::newLabelId(const char* prefix) {
+    return rotulos_.intern(prefix + std::to_string(++labelCounter_));
+}
+
+// linha crua: vira IR quando é "MNEMÔNICO [operando]" conhecido
+void CodeGeneratorBIP::emitInstr(const std::string& instr) {
+    std::string_view s(instr);
+    if (!s.empty() && s.back() == ':') {
+        placeLabel(labelId(std::string(s.substr(0, s.size() - 1))));
+        return;
+    }
+
+    const size_t sp = s.find(' ');
+    BipOp op;
+    if (bipParseMnemonic(s.substr(0, sp), op)) {
+        if (sp == std::string_view::npos) { emit(op); return; }
+
+        const std::string arg(s.substr(sp + 1));
+        if (!arg.empty() && arg.find(' ') == std::string::npos) {
+            if (isIntegerLiteral(arg))  { emitImm(op, std::stol(arg)); return; }
+            if (bipIsJump(op))          { emitBranch(op, labelId(arg)); return; }
+            emitSym(op, dataId(arg));
+            return;
+        }
+    }
+
+    raw_.push_back(instr);
+    push({ BipOp::Raw, BipOperand::Text, static_cast<long>(raw_.size() - 1) });
+}
 
 void CodeGeneratorBIP::emitLabel(const std::string& label) {
-    std::ostringstream oss; oss << sanitizeLabel(label) << ":";
-    text_.push_back(oss.str());
+    placeLabel(labelId(label));
 }
 
 std::string CodeGeneratorBIP::newLabel(const std::string& prefix) {
@@ -171,59 +264,63 @@ std::string CodeGeneratorBIP::newLabel(const std::string& prefix) {
 
 // globais: LDI nome ; LD/STO k
 void CodeGeneratorBIP::emitLoadId(const std::string& nome) {
-    std::string lbl = sanitizeLabel(nome);
-    emitInstr("LD " + lbl);
+    emitSym(BipOp::LD, dataId(nome));
 }
 
 void CodeGeneratorBIP::emitStoreId(const std::string& nome) {
-    std::string lbl = sanitizeLabel(nome);
-    emitInstr("STO " + lbl);     // Mem[lbl] <- ACC
+    emitSym(BipOp::STO, dataId(nome));     // Mem[nome] <- ACC
 }
 
 // vetores com deslocamento constante
 void CodeGeneratorBIP::emitLoadIdOffset(const std::string& nome, int k) {
-    std::string lbl = sanitizeLabel(nome);
-
     // índice constante k no $indr
-    emitInstr("LDI " + std::to_string(k));
-    emitInstr("STO $indr");
+    emitImm(BipOp::LDI, k);
+    emitSym(BipOp::STO, indr_);
 
     // carrega vetor[$indr] em ACC
-    emitInstr("LDV " + lbl);
+    emitSym(BipOp::LDV, dataId(nome));
 }
 
 // ACC -> vetor[k]
 void CodeGeneratorBIP::emitStoreIdOffset(const std::string& nome, int k) {
-    std::string lbl = sanitizeLabel(nome);
-
     // índice constante k no $indr
-    emitInstr("LDI " + std::to_string(k));
-    emitInstr("STO $indr");
+    emitImm(BipOp::LDI, k);
+    emitSym(BipOp::STO, indr_);
 
     // armazena ACC em vetor[$indr]
-    emitInstr("STOV " + lbl);
+    emitSym(BipOp::STOV, dataId(nome));
 }
 
 // aritmética
-void CodeGeneratorBIP::emitAdd() { emitInstr("ADD"); }
-void CodeGeneratorBIP::emitSub() { emitInstr("SUB"); }
-void CodeGeneratorBIP::emitMul() { emitInstr("MUL"); }
-void CodeGeneratorBIP::emitDiv() { emitInstr("DIV"); }
+void CodeGeneratorBIP::emitAdd() { emit(BipOp::ADD); }
+void CodeGeneratorBIP::emitSub() { emit(BipOp::SUB); }
+void CodeGeneratorBIP::emitMul(const std::string& v) {
+    if (isIntegerLiteral(v)) emitMulDiv(t_OPA_MUL, BipOperand::Imm, std::stol(v), 0);
+    else                     emitMulDiv(t_OPA_MUL, BipOperand::Sym, dataId(v), 0);
+}
+void CodeGeneratorBIP::emitDiv(const std::string& v) {
+    if (isIntegerLiteral(v)) emitMulDiv(t_OPA_DIV, BipOperand::Imm, std::stol(v), 0);
+    else                     emitMulDiv(t_OPA_DIV, BipOperand::Sym, dataId(v), 0);
+}
+void CodeGeneratorBIP::emitMod(const std::string& v) {
+    if (isIntegerLiteral(v)) emitMulDiv(t_OPA_MOD, BipOperand::Imm, std::stol(v), 0);
+    else                     emitMulDiv(t_OPA_MOD, BipOperand::Sym, dataId(v), 0);
+}
 
 // bit a bit
-void CodeGeneratorBIP::emitAnd() { emitInstr("AND"); }
-void CodeGeneratorBIP::emitOr()  { emitInstr("OR");  }
-void CodeGeneratorBIP::emitXor() { emitInstr("XOR"); }
-void CodeGeneratorBIP::emitNot() { emitInstr("NOT"); }
-void CodeGeneratorBIP::emitShl() { emitInstr("SHL"); }
-void CodeGeneratorBIP::emitShr() { emitInstr("SHR"); }
+void CodeGeneratorBIP::emitAnd() { emit(BipOp::AND); }
+void CodeGeneratorBIP::emitOr()  { emit(BipOp::OR);  }
+void CodeGeneratorBIP::emitXor() { emit(BipOp::XOR); }
+void CodeGeneratorBIP::emitNot() { emit(BipOp::NOT); }
+void CodeGeneratorBIP::emitShl() { emit(BipOp::SHL); }
+void CodeGeneratorBIP::emitShr() { emit(BipOp::SHR); }
 
 // desvios
 void CodeGeneratorBIP::emitJmp(const std::string& label) {
-    emitInstr("JMP " + sanitizeLabel(label));
+    emitBranch(BipOp::JMP, labelId(label));
 }
 void CodeGeneratorBIP::emitJz(const std::string& label) {
-    emitInstr("JZ " + sanitizeLabel(label));
+    emitBranch(BipOp::JZ, labelId(label));
 }
 
 // =================== Atribuições ===================
@@ -231,23 +328,23 @@ void CodeGeneratorBIP::emitJz(const std::string& label) {
 void CodeGeneratorBIP::emitAssign(const std::string& dest, bool destIsArray, int destIndex,
                                   const std::string& src,  bool srcIsArray,  int srcIndex)
 {
-    std::string d = sanitizeLabel(dest);
-    std::string s = sanitizeLabel(src);
+    const int d = dataId(dest);
+    const int s = srcIsArray ? dataId(src) : -1;
 
     // =============== DESTINO ESCALAR ===============
     if (!destIsArray) {
         // x = v[k];
         if (srcIsArray) {
-            emitInstr("LDI " + std::to_string(srcIndex));
-            emitInstr("STO $indr");
-            emitInstr("LDV " + s);      // ACC = v[k]
+            emitImm(BipOp::LDI, srcIndex);
+            emitSym(BipOp::STO, indr_);
+            emitSym(BipOp::LDV, s);      // ACC = v[k]
             emitStoreId(dest);          // x = ACC
             return;
         }
 
         // x = literal;
         if (isIntegerLiteral(src)) {
-            emitInstr("LDI " + src);
+            emitImm(BipOp::LDI, std::stol(src));
             emitStoreId(dest);
             return;
         }
@@ -264,15 +361,15 @@ void CodeGeneratorBIP::emitAssign(const std::string& dest, bool destIsArray, int
     // d[destIndex] = (literal ou escalar)
     if (!srcIsArray) {
         // fixa índice do destino primeiro
-        emitInstr("LDI " + std::to_string(destIndex));
-        emitInstr("STO $indr");          // $indr = destIndex
+        emitImm(BipOp::LDI, destIndex);
+        emitSym(BipOp::STO, indr_);          // $indr = destIndex
 
         if (isIntegerLiteral(src))
-            emitInstr("LDI " + src);     // ACC = literal
+            emitImm(BipOp::LDI, std::stol(src));     // ACC = literal
         else
             emitLoadId(src);             // ACC = variável
 
-        emitInstr("STOV " + d);          // d[destIndex] = ACC
+        emitSym(BipOp::STOV, d);          // d[destIndex] = ACC
         return;
     }
 
@@ -280,18 +377,18 @@ void CodeGeneratorBIP::emitAssign(const std::string& dest, bool destIsArray, int
     {
         // precisamos de temporário porque usamos $indr duas vezes
         // 1) lê v[srcIndex] em __TMP0
-        emitInstr("LDI " + std::to_string(srcIndex));
-        emitInstr("STO $indr");
-        emitInstr("LDV " + s);               // ACC = v[srcIndex]
-        emitInstr("STO __TMP0");             // guarda
+        emitImm(BipOp::LDI, srcIndex);
+        emitSym(BipOp::STO, indr_);
+        emitSym(BipOp::LDV, s);               // ACC = v[srcIndex]
+        emitSym(BipOp::STO, temp(0));             // guarda
 
         // 2) seta índice de destino
-        emitInstr("LDI " + std::to_string(destIndex));
-        emitInstr("STO $indr");
+        emitImm(BipOp::LDI, destIndex);
+        emitSym(BipOp::STO, indr_);
 
         // 3) recarrega valor e grava em d[destIndex]
-        emitInstr("LD __TMP0");
-        emitInstr("STOV " + d);
+        emitSym(BipOp::LD, temp(0));
+        emitSym(BipOp::STOV, d);
         return;
     }
 
@@ -302,38 +399,113 @@ void CodeGeneratorBIP::emitAssign(const std::string& dest, bool destIsArray, int
 void CodeGeneratorBIP::emitAssignVarIndex(const std::string& dest,
                                           const std::string& idx,
                                           const std::string& src) {
-    std::string lblDest = sanitizeLabel(dest);
-
     // idx -> $indr
     emitLoadId(idx);            // LD idx
-    emitInstr("STO $indr");
+    emitSym(BipOp::STO, indr_);
 
     // src -> ACC
     emitLoadId(src);            // LD src
 
     // ACC -> vetor[$indr]
-    emitInstr("STOV " + lblDest);
+    emitSym(BipOp::STOV, dataId(dest));
 }
 
 
 // =================== construção da .text / programa ===================
+// acrescenta o texto de uma instrução da IR (sem recuo) em 'out'
+void CodeGeneratorBIP::renderInstr(const BipInstr& in, std::string& out) const {
+    if (in.kind == BipOperand::Text) {
+        out += raw_[in.arg];
+        return;
+    }
+    if (in.op == BipOp::Label) {
+        out += rotulos_.texto(static_cast<int>(in.arg));
+        out += ':';
+        return;
+    }
+
+    out += bipMnemonic(in.op);
+    switch (in.kind) {
+    case BipOperand::Label:
+        out += ' ';
+        out += rotulos_.texto(static_cast<int>(in.arg));
+        break;
+    case BipOperand::Sym:
+        out += ' ';
+        out += dados_.texto(static_cast<int>(in.arg));
+        break;
+    case BipOperand::Imm:
+        out += ' ';
+        out += std::to_string(in.arg);
+        break;
+    default:
+        break;
+    }
+}
+
 std::string CodeGeneratorBIP::buildTextSection() const {
-    std::ostringstream oss;
+    std::string out;
+    out.reserve(code_.size() * 12 + 64);
 
     if (opt_.includeTextHeader)
-        oss << ".text\n";
-    oss << opt_.entryLabel << ":\n";
-
-    for (const auto& l : text_) {
-        if (!l.empty() && l.back() == ':')
-            oss << l << "\n";
-        else
-            oss << "    " << l << "\n";
+        out += ".text\n";
+    out += opt_.entryLabel;
+    out += ":\n";
+
+    for (const BipInstr& in : code_) {
+        if (in.op != BipOp::Label)   // rótulos vão sem recuo
+            out += "    ";
+        renderInstr(in, out);
+        out += '\n';
     }
-    oss << "    HLT 0\n";
-    return oss.str();
+    out += "    HLT 0\n";
+    return out;
+}
+
+std::vector<int> CodeGeneratorBIP::textSourcePositions() const {
+    std::vector<int> pos;
+    pos.reserve(code_.size() + 3);
+    if (opt_.includeTextHeader)
+        pos.push_back(-1);              // .text
+    pos.push_back(-1);                  // rótulo de entrada
+    for (const BipInstr& in : code_)
+        pos.push_back(in.pos);
+    pos.push_back(-1);                  // HLT 0
+    return pos;
+}
+
+
+BipVars CodeGeneratorBIP::analysisVars() const {
+    BipVars v;
+    v.data    = static_cast<int>(dados_.size());
+    v.indr    = indr_;
+    v.inPort  = inPort_;
+    v.outPort = outPort_;
+    return v;
+}
+
+std::string CodeGeneratorBIP::varName(int var) const {
+    const BipVars v = analysisVars();
+    if (var == v.acc())    return "ACC";
+    if (var == v.status()) return "STATUS";
+    return std::string(dados_.texto(var));
 }
 
+std::string CodeGeneratorBIP::cfgDot() const {
+    const BipCfg      cfg(code_);
+    const BipLiveness vivas(cfg, analysisVars());
+
+    auto lista = [&](const BitSet& s) {
+        std::string r;
+        s.forEach([&](int x) { r += ' '; r += varName(x); });
+        return r;
+    };
+    return cfg.toDot(
+        [&](const BipInstr& in, std::string& out) { renderInstr(in, out); },
+        [&](int b) {
+            return "in:" + lista(vivas.liveIn(b)) + "\nout:" + lista(vivas.liveOut(b));
+        });
+}
 
 std::string CodeGeneratorBIP::buildProgram(const std::vector<Simbolo>& tabela) const {
     std::ostringstream oss;
@@ -409,7 +581,7 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
 {
     // Caso: dest = constante;
     if (oper.empty() && op2.empty() && isIntegerLiteral(op1)) {
-        emitInstr("LDI " + op1);   // ACC <- literal
+        emitImm(BipOp::LDI, std::stol(op1));   // ACC <- literal
         emitStoreId(dest);         // STO dest
         return;
     }
@@ -427,7 +599,7 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
     // Helper: carrega escalar ou literal em ACC
     auto loadScalarOrLiteral = [this](const std::string& v) {
         if (isIntegerLiteral(v))
-            emitInstr("LDI " + v);
+            emitImm(BipOp::LDI, std::stol(v));
         else
             emitLoadId(v);
     };
@@ -437,15 +609,15 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
                                 const std::string& idx,
                                 bool idxIsLit)
     {
-        std::string a = sanitizeLabel(arr);
+        const int a = dataId(arr);
         if (idxIsLit) {
-            emitInstr("LDI " + idx);
-            emitInstr("STO $indr");
+            emitImm(BipOp::LDI, std::stol(idx));
+            emitSym(BipOp::STO, indr_);
         } else {
             emitLoadId(idx);
-            emitInstr("STO $indr");
+            emitSym(BipOp::STO, indr_);
         }
-        emitInstr("LDV " + a);
+        emitSym(BipOp::LDV, a);
     };
 
     // ============ 1) Nenhum é vetor -> comportamento antigo ============
@@ -456,33 +628,33 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         // Aplica operação com op2
         if (oper == "+") {
             if (isIntegerLiteral(op2))
-                emitInstr("ADDI " + op2);
+                emitImm(BipOp::ADDI, std::stol(op2));
             else
-                emitInstr("ADD " + op2);
+                emitSym(BipOp::ADD, dataId(op2));
         }
         else if (oper == "-") {
             if (isIntegerLiteral(op2))
-                emitInstr("SUBI " + op2);
+                emitImm(BipOp::SUBI, std::stol(op2));
             else
-                emitInstr("SUB " + op2);
+                emitSym(BipOp::SUB, dataId(op2));
         }
         else if (oper == "&") {
             if (isIntegerLiteral(op2))
-                emitInstr("ANDI " + op2);
+                emitImm(BipOp::ANDI, std::stol(op2));
             else
-                emitInstr("AND " + op2);
+                emitSym(BipOp::AND, dataId(op2));
         }
         else if (oper == "|") {
             if (isIntegerLiteral(op2))
-                emitInstr("ORI " + op2);
+                emitImm(BipOp::ORI, std::stol(op2));
             else
-                emitInstr("OR " + op2);
+                emitSym(BipOp::OR, dataId(op2));
         }
         else if (oper == "^") {
             if (isIntegerLiteral(op2))
-                emitInstr("XORI " + op2);
+                emitImm(BipOp::XORI, std::stol(op2));
             else
-                emitInstr("XOR " + op2);
+                emitSym(BipOp::XOR, dataId(op2));
         }
         else if (oper.empty()) {
             // dest = op1; já está em ACC
@@ -500,33 +672,33 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
 
         if (oper == "+") {
             if (isIntegerLiteral(op2))
-                emitInstr("ADDI " + op2);
+                emitImm(BipOp::ADDI, std::stol(op2));
             else
-                emitInstr("ADD " + op2);
+                emitSym(BipOp::ADD, dataId(op2));
         }
         else if (oper == "-") {
             if (isIntegerLiteral(op2))
-                emitInstr("SUBI " + op2);
+                emitImm(BipOp::SUBI, std::stol(op2));
             else
-                emitInstr("SUB " + op2);
+                emitSym(BipOp::SUB, dataId(op2));
         }
         else if (oper == "&") {
             if (isIntegerLiteral(op2))
-                emitInstr("ANDI " + op2);
+                emitImm(BipOp::ANDI, std::stol(op2));
             else
-                emitInstr("AND " + op2);
+                emitSym(BipOp::AND, dataId(op2));
         }
         else if (oper == "|") {
             if (isIntegerLiteral(op2))
-                emitInstr("ORI " + op2);
+                emitImm(BipOp::ORI, std::stol(op2));
             else
-                emitInstr("OR " + op2);
+                emitSym(BipOp::OR, dataId(op2));
         }
         else if (oper == "^") {
             if (isIntegerLiteral(op2))
-                emitInstr("XORI " + op2);
+                emitImm(BipOp::XORI, std::stol(op2));
             else
-                emitInstr("XOR " + op2);
+                emitSym(BipOp::XOR, dataId(op2));
         }
         // oper vazio não cai aqui (já tratado antes)
 
@@ -541,19 +713,19 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         if (isComm(oper)) {
             // guarda op1 em __TMP0
             loadScalarOrLiteral(op1);      // ACC = op1
-            emitInstr("STO __TMP0");
+            emitSym(BipOp::STO, temp(0));
 
             // ACC = v[idx]
             loadArrayElem(arr2, idx2, idx2IsLit);
 
             if (oper == "+")
-                emitInstr("ADD __TMP0");
+                emitSym(BipOp::ADD, temp(0));
             else if (oper == "&")
-                emitInstr("AND __TMP0");
+                emitSym(BipOp::AND, temp(0));
             else if (oper == "|")
-                emitInstr("OR __TMP0");
+                emitSym(BipOp::OR, temp(0));
             else if (oper == "^")
-                emitInstr("XOR __TMP0");
+                emitSym(BipOp::XOR, temp(0));
 
             emitStoreId(dest);
             return;
@@ -563,13 +735,13 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         if (oper == "-") {
             // 1) carrega v[idx] e guarda em __TMP0
             loadArrayElem(arr2, idx2, idx2IsLit);   // ACC = v[idx]
-            emitInstr("STO __TMP0");
+            emitSym(BipOp::STO, temp(0));
 
             // 2) ACC = op1
             loadScalarOrLiteral(op1);
 
             // 3) ACC = op1 - v[idx]
-            emitInstr("SUB __TMP0");
+            emitSym(BipOp::SUB, temp(0));
 
             emitStoreId(dest);
             return;
@@ -586,19 +758,19 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         if (isComm(oper)) {
             // ACC = v1[idx1], guarda em __TMP0
             loadArrayElem(arr1, idx1, idx1IsLit);
-            emitInstr("STO __TMP0");
+            emitSym(BipOp::STO, temp(0));
 
             // ACC = v2[idx2]
             loadArrayElem(arr2, idx2, idx2IsLit);
 
             if (oper == "+")
-                emitInstr("ADD __TMP0");
+                emitSym(BipOp::ADD, temp(0));
             else if (oper == "&")
-                emitInstr("AND __TMP0");
+                emitSym(BipOp::AND, temp(0));
             else if (oper == "|")
-                emitInstr("OR __TMP0");
+                emitSym(BipOp::OR, temp(0));
             else if (oper == "^")
-                emitInstr("XOR __TMP0");
+                emitSym(BipOp::XOR, temp(0));
 
             emitStoreId(dest);
             return;
@@ -608,13 +780,13 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         if (oper == "-") {
             // 1) ACC = v2[idx2]; guarda em __TMP0
             loadArrayElem(arr2, idx2, idx2IsLit);
-            emitInstr("STO __TMP0");
+            emitSym(BipOp::STO, temp(0));
 
             // 2) ACC = v1[idx1]
             loadArrayElem(arr1, idx1, idx1IsLit);
 
             // 3) ACC = v1[idx1] - v2[idx2]
-            emitInstr("SUB __TMP0");
+            emitSym(BipOp::SUB, temp(0));
 
             emitStoreId(dest);
             return;
@@ -624,3 +796,1562 @@ void CodeGeneratorBIP::emitAssignSimpleExpr(const std::string& dest,
         return;
     }
 }
+
+// =================== Geração a partir da AST ===================
+static bool isSimpleOperand(const AstNode* e) {
+    return e && (e->kind == AstKind::Id || e->kind == AstKind::IntLit);
+}
+
+static bool isRelational(int op) {
+    return op == t_OPR_IGUAL || op == t_OPR_DIFERENTE ||
+           op == t_OPR_MAIOR || op == t_OPR_MENOR   ||
+           op == t_OPR_MAIOR_IGUAL || op == t_OPR_MENOR_IGUAL;
+}
+
+static bool isLogical(int op) {
+    return op == t_OPL_AND || op == t_OPL_OR;
+}
+
+// instruções BIP do operador binário: forma direta e com imediato
+// (deslocamentos usam a mesma instrução para as duas)
+static bool binaryOps(int op, BipOp& direta, BipOp& imediata) {
+    switch (op) {
+    case t_OPA_SUM:  direta = BipOp::ADD; imediata = BipOp::ADDI; return true;
+    case t_OPA_SUB:  direta = BipOp::SUB; imediata = BipOp::SUBI; return true;
+    case t_OPA_MUL:  direta = BipOp::MUL; imediata = BipOp::MULI; return true;
+    case t_OPA_DIV:  direta = BipOp::DIV; imediata = BipOp::DIVI; return true;
+    case t_OPA_MOD:  direta = BipOp::MOD; imediata = BipOp::MODI; return true;
+    case t_OPBB_AND: direta = BipOp::AND; imediata = BipOp::ANDI; return true;
+    case t_OPBB_OR:  direta = BipOp::OR;  imediata = BipOp::ORI;  return true;
+    case t_OPBB_XOR: direta = BipOp::XOR; imediata = BipOp::XORI; return true;
+    case t_OPBB_DE:  direta = imediata = BipOp::SLL; return true;
+    case t_OPBB_DD:  direta = imediata = BipOp::SRL; return true;
+    default:         return false;
+    }
+}
+
+// desvio tomado quando "a op b" é VERDADEIRA (após SUB)
+static BipOp branchIfTrue(int op) {
+    switch (op) {
+    case t_OPR_MAIOR:       return BipOp::BGT;
+    case t_OPR_MENOR:       return BipOp::BLT;
+    case t_OPR_MAIOR_IGUAL: return BipOp::BGE;
+    case t_OPR_MENOR_IGUAL: return BipOp::BLE;
+    case t_OPR_IGUAL:       return BipOp::BEQ;
+    default:                return BipOp::BNE;   // t_OPR_DIFERENTE
+    }
+}
+
+// desvio tomado quando "a op b" é FALSA (após SUB)
+static BipOp branchIfFalse(int op) {
+    switch (op) {
+    case t_OPR_MAIOR:       return BipOp::BLE;
+    case t_OPR_MENOR:       return BipOp::BGE;
+    case t_OPR_MAIOR_IGUAL: return BipOp::BLT;
+    case t_OPR_MENOR_IGUAL: return BipOp::BGT;
+    case t_OPR_IGUAL:       return BipOp::BNE;
+    default:                return BipOp::BEQ;   // t_OPR_DIFERENTE
+    }
+}
+
+// valor constante de uma inicialização (literal, opcionalmente negado)
+static bool constInit(const AstNode* e, long& v) {
+    if (!e) return false;
+    if (e->kind == AstKind::IntLit) { v = e->value; return true; }
+    if (e->kind == AstKind::Unary && e->op == t_OPA_SUB &&
+        e->a && e->a->kind == AstKind::IntLit) {
+        v = -e->a->value;
+        return true;
+    }
+    return false;
+}
+
+// ===== dobra de constantes =====
+// A BIP tem ACC de 16 bits: os resultados dobrados seguem a mesma aritmética
+static long wrap16(long v) { return static_cast<int16_t>(static_cast<uint16_t>(v)); }
+
+static bool isCommutative(int op) {
+    return op == t_OPA_SUM || op == t_OPA_MUL ||
+           op == t_OPBB_AND || op == t_OPBB_OR || op == t_OPBB_XOR;
+}
+
+// "k op x" -> "x op' k"
+static int mirrorRelational(int op) {
+    switch (op) {
+    case t_OPR_MAIOR:       return t_OPR_MENOR;
+    case t_OPR_MENOR:       return t_OPR_MAIOR;
+    case t_OPR_MAIOR_IGUAL: return t_OPR_MENOR_IGUAL;
+    case t_OPR_MENOR_IGUAL: return t_OPR_MAIOR_IGUAL;
+    default:                return op;           // == e != são simétricos
+    }
+}
+
+// "x op k" == x
+static bool isIdentity(int op, long k) {
+    if (k == 0)
+        return op == t_OPA_SUM || op == t_OPA_SUB || op == t_OPBB_OR ||
+               op == t_OPBB_XOR || op == t_OPBB_DE || op == t_OPBB_DD;
+    return k == 1 && (op == t_OPA_MUL || op == t_OPA_DIV);
+}
+// "x op k" == 0
+static bool isAbsorbing(int op, long k) {
+    return k == 0 && (op == t_OPA_MUL || op == t_OPBB_AND);
+}
+
+static bool hasSideEffects(const AstNode* e) {
+    for (; e; e = e->next) {
+        if (e->kind == AstKind::Call || e->kind == AstKind::IncDec)
+            return true;
+        if (hasSideEffects(e->a) || hasSideEffects(e->b))
+            return true;
+    }
+    return false;
+}
+
+// lê/escreve o $indr: acesso a vetor ou chamada (a função pode usar vetores)
+static bool touchesIndr(const AstNode* e) {
+    for (; e; e = e->next) {
+        if (e->kind == AstKind::Index || e->kind == AstKind::Call)
+            return true;
+        if (touchesIndr(e->a) || touchesIndr(e->b))
+            return true;
+    }
+    return false;
+}
+
+// tamanho aproximado do código de n, em instruções: cerca de uma por nó
+static long sizeEstimate(const AstNode* n) {
+    long s = 0;
+    for (; n; n = n->next)
+        s += 1 + sizeEstimate(n->a) + sizeEstimate(n->b) + sizeEstimate(n->c) + sizeEstimate(n->d);
+    return s;
+}
+
+static bool evalBinary(int op, long a, long b, long& r) {
+    switch (op) {
+    case t_OPA_SUM:  r = a + b; break;
+    case t_OPA_SUB:  r = a - b; break;
+    case t_OPA_MUL:  r = a * b; break;
+    case t_OPA_DIV:  if (b == 0) return false; r = a / b; break;
+    case t_OPA_MOD:  if (b == 0) return false; r = a % b; break;
+    case t_OPBB_AND: r = a & b; break;
+    case t_OPBB_OR:  r = a | b; break;
+    case t_OPBB_XOR: r = a ^ b; break;
+    case t_OPBB_DE:
+        if (b < 0 || b > 15) return false;
+        r = static_cast<uint16_t>(a) << b;
+        break;
+    case t_OPBB_DD:
+        if (b < 0 || b > 15) return false;
+        r = static_cast<uint16_t>(a) >> b;
+        break;
+    // relacionais: decididas como no código gerado, pelo sinal de a - b
+    case t_OPR_IGUAL:       r = wrap16(a - b) == 0; return true;
+    case t_OPR_DIFERENTE:   r = wrap16(a - b) != 0; return true;
+    case t_OPR_MAIOR:       r = wrap16(a - b) >  0; return true;
+    case t_OPR_MENOR:       r = wrap16(a - b) <  0; return true;
+    case t_OPR_MAIOR_IGUAL: r = wrap16(a - b) >= 0; return true;
+    case t_OPR_MENOR_IGUAL: r = wrap16(a - b) <= 0; return true;
+    case t_OPL_AND:         r = a != 0 && b != 0;   return true;
+    case t_OPL_OR:          r = a != 0 || b != 0;   return true;
+    default: return false;
+    }
+    r = wrap16(r);
+    return true;
+}
+
+int CodeGeneratorBIP::symData(int sym, std::string_view nome) {
+    if (sym < 0) return dataId(std::string(nome));
+    if (static_cast<std::size_t>(sym) >= labels_.size())
+        labels_.resize(sym + 1, -1);
+    int& d = labels_[sym];
+    if (d < 0) d = dataId(std::string(nome));
+    return d;
+}
+
+int CodeGeneratorBIP::varSym(const AstNode* n) {
+    if (currentFunction_ && n->sym >= 0) {
+        for (const auto& p : currentFunction_->params)
+            if (p.sym == n->sym) return p.data;
+    }
+    return symData(n->sym, n->name);
+}
+
+int CodeGeneratorBIP::temp(int k) {
+    // com sethiUllman cada função tem os seus; allocateTemps() junta depois
+    // os que nunca estão vivos ao mesmo tempo
+    if (opt_.sethiUllman && currentFunction_) {
+        const long long chave = (static_cast<long long>(currentFunction_->label) << 32) | k;
+        auto [it, novo] = tempVirtualDe_.try_emplace(chave, static_cast<int>(tempsVirtuais_.size()));
+        if (novo) {
+            const std::string nome = "__TMP" + std::to_string(k) + "@" +
+                                     std::string(rotulos_.texto(currentFunction_->label));
+            tempsVirtuais_.push_back({ dados_.intern(nome), k });
+        }
+        return tempsVirtuais_[it->second].dado;
+    }
+    return physicalTemp(k);
+}
+
+int CodeGeneratorBIP::physicalTemp(int k) {
+    if (k + 1 > tempCount_) tempCount_ = k + 1;
+    if (static_cast<std::size_t>(k) >= temps_.size())
+        temps_.resize(k + 1, -1);
+    if (temps_[k] < 0) temps_[k] = dados_.intern("__TMP" + std::to_string(k));
+    return temps_[k];
+}
+
+// Literais e expressões sem efeito colateral sobre escalares de valor
+// conhecido (consts_). Vetores, chamadas e ++/-- nunca são constantes.
+// ===== aritmética =====
+void CodeGeneratorBIP::emitArith(int op, BipOperand kind, long arg, int t) {
+    if (op == t_OPA_MUL || op == t_OPA_DIV || op == t_OPA_MOD) {
+        emitMulDiv(op, kind, arg, t);
+        return;
+    }
+    BipOp direta, imediata;
+    if (!binaryOps(op, direta, imediata)) return;
+    push({ kind == BipOperand::Imm ? imediata : direta, kind, arg });
+}
+
+void CodeGeneratorBIP::emitNegate() {
+    emit(BipOp::NOT);
+    emitImm(BipOp::ADDI, 1);
+}
+
+// esquerdo (ACC) em __RT_A, direito no ACC
+void CodeGeneratorBIP::emitCallRoutine(BipRoutine r, BipOperand kind, long arg) {
+    emitSym(BipOp::STO, dataId("__RT_A"));
+    push({ kind == BipOperand::Imm ? BipOp::LDI : BipOp::LD, kind, arg });
+    emitBranch(BipOp::CALL, labelId(bipRoutineLabel(r)));
+    rotinas_ |= bipRoutineBit(r);
+}
+
+static int highBit(unsigned long v) {
+    int n = -1;
+    for (; v; v >>= 1) ++n;
+    return n;
+}
+
+static int bitCount(unsigned long v) {
+    int n = 0;
+    for (; v; v &= v - 1) ++n;
+    return n;
+}
+
+// A BIP não tem MUL/DIV/MOD. Com constante: potência de dois vira SLL, SRL
+// ou ANDI, e multiplicador com até 3 bits (ou 2^n - 1) vira somas de
+// deslocamentos sobre __TMPt. O resto chama a biblioteca (bipruntime.h).
+void CodeGeneratorBIP::emitMulDiv(int op, BipOperand kind, long arg, int t) {
+    const BipRoutine rotina = op == t_OPA_MUL ? BipRoutine::Mul
+                            : op == t_OPA_DIV ? BipRoutine::Div : BipRoutine::Mod;
+    if (kind != BipOperand::Imm) {
+        emitCallRoutine(rotina, kind, arg);
+        return;
+    }
+
+    const long k = wrap16(arg);
+    const unsigned long m = static_cast<unsigned long>(k < 0 ? -k : k);   // |k| <= 0x8000
+
+    if (op == t_OPA_MUL) {
+        if (m == 0) {
+            emitImm(BipOp::LDI, 0);
+            return;
+        }
+        const int topo = highBit(m);
+        if (bitCount(m) == 1) {
+            if (topo > 0) emitImm(BipOp::SLL, topo);
+        } else if (bitCount(m + 1) == 1) {          // 2^n - 1: (x << n) - x
+            const int tmp = temp(t);
+            emitSym(BipOp::STO, tmp);
+            emitImm(BipOp::SLL, topo + 1);
+            emitSym(BipOp::SUB, tmp);
+        } else if (bitCount(m) <= 3) {              // Horner sobre os bits de m
+            const int tmp = temp(t);
+            emitSym(BipOp::STO, tmp);
+            int desloc = 0;
+            for (int b = topo - 1; b >= 0; --b) {
+                ++desloc;
+                if ((m >> b) & 1) {
+                    emitImm(BipOp::SLL, desloc);
+                    emitSym(BipOp::ADD, tmp);
+                    desloc = 0;
+                }
+            }
+            if (desloc > 0) emitImm(BipOp::SLL, desloc);
+        } else {
+            emitCallRoutine(rotina, BipOperand::Imm, k);
+            return;
+        }
+        if (k < 0) emitNegate();
+        return;
+    }
+
+    if (m == 1) {                                   // x / ±1, x % ±1
+        if (op == t_OPA_MOD)  emitImm(BipOp::LDI, 0);
+        else if (k < 0)       emitNegate();
+        return;
+    }
+    if (bitCount(m) != 1) {                         // inclui divisão por zero
+        emitCallRoutine(rotina, BipOperand::Imm, k);
+        return;
+    }
+
+    // 2^n: a divisão trunca para zero (e o resto segue o sinal do dividendo),
+    // então negativo passa pelo módulo: -((-x) >> n), -((-x) & (2^n - 1))
+    auto reduz = [&]() {
+        if (op == t_OPA_DIV) emitImm(BipOp::SRL, highBit(m));
+        else                 emitImm(BipOp::ANDI, static_cast<long>(m - 1));
+    };
+    const int lblNeg = newLabelId("_DIV_N");
+    const int lblFim = newLabelId("_DIV_E");
+    emitImm(BipOp::ADDI, 0);                        // STATUS = ACC
+    emitBranch(BipOp::BLT, lblNeg);
+    reduz();
+    emitBranch(BipOp::JMP, lblFim);
+    placeLabel(lblNeg);
+    emitNegate();
+    reduz();
+    emitNegate();
+    placeLabel(lblFim);
+    if (op == t_OPA_DIV && k < 0) emitNegate();
+}
+
+void CodeGeneratorBIP::linkRuntime() {
+    unsigned faltam = rotinas_;
+    for (bool mudou = true; mudou; ) {
+        const unsigned antes = faltam;
+        for (int r = 0; r < kBipRoutineCount; ++r)
+            if (faltam & (1u << r)) faltam |= bipRoutineDeps(static_cast<BipRoutine>(r));
+        mudou = faltam != antes;
+    }
+    faltam &= ~linkadas_;
+    if (!faltam) return;
+
+    // o que vem antes pode seguir direto para cá (ex.: comandos globais
+    // depois de main): termina como o "HLT 0" de buildTextSection
+    const BipOp ultima = code_.empty() ? BipOp::Label : code_.back().op;
+    if (ultima != BipOp::JMP && ultima != BipOp::RETURN && ultima != BipOp::HLT)
+        emitImm(BipOp::HLT, 0);
+
+    for (int r = 0; r < kBipRoutineCount; ++r) {
+        if (!(faltam & (1u << r))) continue;
+        for (std::string_view linha : bipRoutineCode(static_cast<BipRoutine>(r)))
+            emitInstr(std::string(linha));
+    }
+    linkadas_ |= faltam;
+}
+
+bool CodeGeneratorBIP::foldConst(const AstNode* e, long& v) {
+    if (!e) return false;
+    if (e->kind == AstKind::IntLit) { v = e->value; return true; }
+    if (!opt_.constantFolding) return false;
+
+    switch (e->kind) {
+    case AstKind::Id: {
+        auto it = consts_.find(varSym(e));
+        if (it == consts_.end()) return false;
+        v = it->second;
+        return true;
+    }
+    case AstKind::Unary: {
+        long a = 0;
+        if (!foldConst(e->a, a)) return false;
+        switch (e->op) {
+        case t_OPA_SUB:  v = wrap16(-a); return true;
+        case t_OPA_SUM:  v = a;          return true;
+        case t_OPBB_NOT: v = wrap16(~a); return true;
+        case t_OPL_DIFF: v = a == 0;     return true;
+        default:         return false;
+        }
+    }
+    case AstKind::Binary: {
+        long a = 0, b = 0;
+        if (!foldConst(e->a, a)) {
+            // "x && 0" / "x || 1", com x sem efeito colateral
+            if (e->op != t_OPL_AND && e->op != t_OPL_OR) return false;
+            if (!foldConst(e->b, b) || hasSideEffects(e->a)) return false;
+            if (e->op == t_OPL_AND && b == 0) { v = 0; return true; }
+            if (e->op == t_OPL_OR  && b != 0) { v = 1; return true; }
+            return false;
+        }
+        // curto-circuito: "0 && f()" não chama f
+        if (e->op == t_OPL_AND && a == 0) { v = 0; return true; }
+        if (e->op == t_OPL_OR  && a != 0) { v = 1; return true; }
+        if (!foldConst(e->b, b)) return false;
+        return evalBinary(e->op, a, b, v);
+    }
+    default:
+        return false;
+    }
+}
+
+// Antes de um laço (ou de juntar caminhos) esquece as variáveis que o
+// trecho pode alterar; uma chamada pode alterar qualquer global.
+void CodeGeneratorBIP::forgetAssigned(const AstNode* n) {
+    for (; n && !consts_.empty(); n = n->next) {
+        switch (n->kind) {
+        case AstKind::Call:
+            consts_.clear();
+            return;
+        case AstKind::Assign:
+        case AstKind::IncDec:
+            if (n->a && n->a->kind == AstKind::Id)
+                consts_.erase(varSym(n->a));
+            break;
+        case AstKind::VarDecl:
+            consts_.erase(varSym(n));
+            break;
+        case AstKind::Cin:
+            for (const AstNode* t = n->a; t; t = t->next)
+                if (t->kind == AstKind::Id) consts_.erase(varSym(t));
+            break;
+        default:
+            break;
+        }
+        forgetAssigned(n->a);
+        forgetAssigned(n->b);
+        forgetAssigned(n->c);
+        forgetAssigned(n->d);
+    }
+}
+
+// Escalar ou vetor (qualquer posição). Conservador: qualquer chamada conta
+// como escrita (pode ser global).
+bool CodeGeneratorBIP::mayAssign(const AstNode* n, int dado) {
+    for (; n; n = n->next) {
+        switch (n->kind) {
+        case AstKind::Call:
+            return true;
+        case AstKind::Assign:
+        case AstKind::IncDec:
+            if (n->a && varSym(n->a) == dado)
+                return true;
+            break;
+        case AstKind::VarDecl:
+            if (varSym(n) == dado) return true;
+            break;
+        case AstKind::Cin:
+            for (const AstNode* t = n->a; t; t = t->next)
+                if (varSym(t) == dado) return true;
+            break;
+        default:
+            break;
+        }
+        if (mayAssign(n->a, dado) || mayAssign(n->b, dado) ||
+            mayAssign(n->c, dado) || mayAssign(n->d, dado))
+            return true;
+    }
+    return false;
+}
+
+// Voltas de "for (init; i op K; passo)": i conhecido depois do init
+// ('aposInit'), K constante no laço (consts_ já sem o que o laço escreve),
+// passo "i++"/"i--" ou "i = expr" que dobra com i conhecido, e o corpo sem
+// escrever i. A sequência de i é simulada em 16 bits, como a máquina faz.
+bool CodeGeneratorBIP::tripCount(const AstNode* f, const std::unordered_map<int, long>& aposInit,
+                                 long& vezes) {
+    const AstNode* c = f->b;
+    if (!c || c->kind != AstKind::Binary || !isRelational(c->op) || c->a->kind != AstKind::Id)
+        return false;
+    const int i = varSym(c->a);
+    const auto ini = aposInit.find(i);
+    long limite = 0;
+    if (ini == aposInit.end() || !foldConst(c->b, limite) || mayAssign(f->d, i))
+        return false;
+
+    const AstNode* passo = f->c;
+    if (passo && passo->kind == AstKind::ExprStmt) passo = passo->a;
+    if (!passo || passo->next || (passo->kind != AstKind::IncDec && passo->kind != AstKind::Assign) ||
+        passo->a->kind != AstKind::Id || varSym(passo->a) != i)
+        return false;
+
+    long v = ini->second;
+    for (vezes = 0; ; ++vezes) {
+        long r = 0;
+        evalBinary(c->op, v, limite, r);
+        if (!r) return true;
+        if (vezes > 0xFFFF) return false;             // i repete valores: não termina
+        if (passo->kind == AstKind::IncDec) {
+            v = wrap16(v + (passo->op == t_OPA_SUM1 ? 1 : -1));
+        } else {
+            consts_[i] = v;
+            const bool ok = foldConst(passo->b, v);
+            consts_.erase(i);
+            if (!ok) return false;
+        }
+    }
+}
+
+// mesma expressão, nó a nó (sem olhar 'next')
+static bool sameExpr(const AstNode* x, const AstNode* y) {
+    if (!x || !y) return x == y;
+    return x->kind == y->kind && x->op == y->op && x->value == y->value &&
+           x->sym == y->sym && x->name == y->name &&
+           sameExpr(x->a, y->a) && sameExpr(x->b, y->b);
+}
+
+static bool containsCall(const AstNode* n) {
+    for (; n; n = n->next) {
+        if (n->kind == AstKind::Call) return true;
+        if (containsCall(n->a) || containsCall(n->b) || containsCall(n->c) || containsCall(n->d))
+            return true;
+    }
+    return false;
+}
+
+// x * c sai por no máximo três instruções (ver emitMulDiv)
+static bool cheapMul(long c) {
+    const long k = wrap16(c);
+    const unsigned long m = static_cast<unsigned long>(k < 0 ? -k : k);
+    return m == 0 || bitCount(m) == 1 || (k > 0 && bitCount(m + 1) == 1);
+}
+
+// Prepara o laço n (While/DoWhile/For) para LICM: subexpressões que não
+// mudam entre as voltas (sem efeito colateral, lendo só o que o laço não
+// escreve) e, no for, "i * c" com i variável de indução viram leituras de
+// __INVk. Devolve n ou uma cópia com as partes repetidas reescritas; 'hs'
+// diz o que emitPreheader/emitInductionSteps precisam emitir. Um laço com
+// chamada fica como está: a função pode escrever globais e, recursiva,
+// também os locais (que são estáticos na BIP).
+const AstNode* CodeGeneratorBIP::hoistLoop(const AstNode* n, std::vector<LoopHoist>& hs) {
+    if (!opt_.loopInvariants) return n;
+
+    AstNode copia = *n;
+    AstNode** campos[3] = { &copia.b, &copia.c, &copia.d };
+    HoistCtx cx;
+    cx.hs = &hs;
+    cx.np = 3;
+    if (n->kind != AstKind::For) {
+        campos[0] = &copia.a;
+        campos[1] = &copia.b;
+        cx.np = 2;
+    }
+    for (int k = 0; k < cx.np; ++k) {
+        cx.partes[k] = *campos[k];
+        if (containsCall(cx.partes[k])) return n;
+    }
+
+    // variável de indução: só o passo "i++", "i--", "i = i +- K" a escreve
+    const AstNode* passo = n->kind == AstKind::For ? n->c : nullptr;
+    if (passo && passo->kind == AstKind::ExprStmt) passo = passo->a;
+    if (passo && !passo->next && passo->a && passo->a->kind == AstKind::Id) {
+        const int i = varSym(passo->a);
+        long k = 0;
+        bool ok = false;
+        if (passo->kind == AstKind::IncDec) {
+            k = passo->op == t_OPA_SUM1 ? 1 : -1;
+            ok = true;
+        } else if (passo->kind == AstKind::Assign && passo->b->kind == AstKind::Binary &&
+                   (passo->b->op == t_OPA_SUM || passo->b->op == t_OPA_SUB)) {
+            const AstNode* x = passo->b->a;
+            const AstNode* y = passo->b->b;
+            auto ehI = [&](const AstNode* e) { return e->kind == AstKind::Id && varSym(e) == i; };
+            if (ehI(x) && foldConst(y, k)) {
+                if (passo->b->op == t_OPA_SUB) k = -k;
+                ok = true;
+            } else if (passo->b->op == t_OPA_SUM && ehI(y) && foldConst(x, k)) {
+                ok = true;
+            }
+        }
+        if (ok && !mayAssign(n->b, i) && !mayAssign(n->d, i)) {
+            cx.iv = i;
+            cx.ivPasso = wrap16(k);
+        }
+    }
+
+    for (int k = 0; k < cx.np; ++k)
+        *campos[k] = hoistIn(cx.partes[k], cx);
+    if (hs.empty()) return n;
+    sinteticos_.push_back(copia);
+    return &sinteticos_.back();
+}
+
+AstNode* CodeGeneratorBIP::hoistIn(const AstNode* n, HoistCtx& cx) {
+    if (!n) return nullptr;
+    AstNode* next = hoistIn(n->next, cx);
+
+    long c = 0, passo = 0;
+    bool sobe = false;
+    if ((n->kind == AstKind::Unary || n->kind == AstKind::Binary || n->kind == AstKind::Index) &&
+        !foldConst(n, c)) {
+        if (loopInvariant(n, cx)) {
+            sobe = true;
+        } else if (cx.iv >= 0 && n->kind == AstKind::Binary && n->op == t_OPA_MUL) {
+            // i * c: soma c * passo a cada volta em vez de multiplicar
+            auto ehI = [&](const AstNode* e) { return e->kind == AstKind::Id && varSym(e) == cx.iv; };
+            if ((ehI(n->a) && foldConst(n->b, c)) || (ehI(n->b) && foldConst(n->a, c))) {
+                sobe = !cheapMul(c);
+                passo = wrap16(c * cx.ivPasso);
+            }
+        }
+    }
+
+    if (sobe) {
+        int dado = -1;
+        for (const LoopHoist& h : *cx.hs)
+            if (h.passo == passo && sameExpr(h.expr, n)) dado = h.dado;
+        if (dado < 0) {
+            dado = dados_.intern("__INV" + std::to_string(invCount_++));
+            if (opt_.sethiUllman && currentFunction_) tempsVirtuais_.push_back({ dado, -1 });
+            invs_.push_back(dado);
+            cx.hs->push_back({ n, dado, passo });
+        }
+        AstNode id;
+        id.kind = AstKind::Id;
+        id.pos  = n->pos;
+        id.name = dados_.texto(dado);
+        id.next = next;
+        sinteticos_.push_back(id);
+        return &sinteticos_.back();
+    }
+
+    AstNode copia = *n;
+    copia.a = hoistIn(n->a, cx);
+    copia.b = hoistIn(n->b, cx);
+    copia.c = hoistIn(n->c, cx);
+    copia.d = hoistIn(n->d, cx);
+    copia.next = next;
+    if (copia.a == n->a && copia.b == n->b && copia.c == n->c && copia.d == n->d && next == n->next)
+        return const_cast<AstNode*>(n);           // nada mudou: reaproveita o original
+    sinteticos_.push_back(copia);
+    return &sinteticos_.back();
+}
+
+bool CodeGeneratorBIP::loopInvariant(const AstNode* e, const HoistCtx& cx) {
+    auto escrito = [&](const AstNode* x) {
+        const int dado = varSym(x);
+        for (int k = 0; k < cx.np; ++k)
+            if (mayAssign(cx.partes[k], dado)) return true;
+        return false;
+    };
+    switch (e->kind) {
+    case AstKind::IntLit: return true;
+    case AstKind::Id:     return !escrito(e);
+    case AstKind::Index:  return loopInvariant(e->a, cx) && !escrito(e);
+    case AstKind::Unary:  return loopInvariant(e->a, cx);
+    case AstKind::Binary: return loopInvariant(e->a, cx) && loopInvariant(e->b, cx);
+    default:              return false;
+    }
+}
+
+void CodeGeneratorBIP::emitPreheader(const std::vector<LoopHoist>& hs) {
+    for (const LoopHoist& h : hs) {
+        genExpr(h.expr, 0);
+        emitSym(BipOp::STO, h.dado);
+    }
+}
+
+// depois do passo do for: cada i * c acompanha o novo i
+void CodeGeneratorBIP::emitInductionSteps(const std::vector<LoopHoist>& hs) {
+    for (const LoopHoist& h : hs) {
+        if (h.passo == 0) continue;
+        emitSym(BipOp::LD, h.dado);
+        emitImm(BipOp::ADDI, h.passo);
+        emitSym(BipOp::STO, h.dado);
+    }
+}
+
+// conhecimento comum aos dois caminhos de um if
+static void intersect(std::unordered_map<int, long>& a, const std::unordered_map<int, long>& b) {
+    for (auto it = a.begin(); it != a.end(); ) {
+        auto jt = b.find(it->first);
+        if (jt == b.end() || jt->second != it->second)
+            it = a.erase(it);
+        else
+            ++it;
+    }
+}
+
+// __TMPk virtuais -> __TMPn compartilhados (temppool.h); os globais ficam
+// fixos no próprio slot
+void CodeGeneratorBIP::allocateTemps() {
+    if (tempsVirtuais_.empty()) return;
+
+    std::vector<int> temps, cor;
+    for (std::size_t k = 0; k < temps_.size(); ++k) {
+        if (temps_[k] < 0) continue;
+        temps.push_back(temps_[k]);
+        cor.push_back(static_cast<int>(k));
+    }
+    const std::size_t primeiro = temps.size();
+    for (const TempVirtual& tv : tempsVirtuais_) {
+        temps.push_back(tv.dado);
+        cor.push_back(-1);
+    }
+
+    std::vector<int> slot(dados_.size(), -1);
+    if (colorTemps(code_, analysisVars(), temps, cor) >= 0) {
+        for (std::size_t i = primeiro; i < temps.size(); ++i)
+            slot[temps[i]] = cor[i];
+        invs_.erase(std::remove_if(invs_.begin(), invs_.end(),
+                                   [&](int d) { return slot[d] >= 0; }), invs_.end());
+    } else {
+        // CFG incompleto: volta ao __TMPk pela profundidade (__INVk fica como está)
+        for (const TempVirtual& tv : tempsVirtuais_)
+            if (tv.k >= 0) slot[tv.dado] = tv.k;
+    }
+    for (BipInstr& in : code_)
+        if (in.kind == BipOperand::Sym && slot[in.arg] >= 0)
+            in.arg = physicalTemp(slot[in.arg]);
+
+    tempsVirtuais_.clear();
+    tempVirtualDe_.clear();
+}
+
+// Sethi–Ullman para a máquina de acumulador: operando simples entra direto
+// na instrução; operando composto à direita é calculado antes e guardado
+// num __TMP enquanto o esquerdo usa os seguintes
+int CodeGeneratorBIP::tempsNeeded(const AstNode* e) {
+    long k = 0;
+    if (!e || isSimpleOperand(e) || foldConst(e, k))
+        return 0;
+
+    switch (e->kind) {
+    case AstKind::Index:
+        return tempsNeeded(e->a);
+    case AstKind::Call: {
+        int n = 0;
+        for (const AstNode* a = e->a; a; a = a->next)
+            n = std::max(n, tempsNeeded(a));
+        return n;
+    }
+    case AstKind::IncDec:
+        return 1;
+    case AstKind::Unary:
+        return tempsNeeded(e->a);
+    case AstKind::Binary: {
+        const int na = tempsNeeded(e->a);
+        const int nb = tempsNeeded(e->b);
+        if (isLogical(e->op))
+            return std::max(na, nb);
+        if (isSimpleOperand(e->b) || foldConst(e->b, k))
+            return std::max(na, e->op == t_OPA_MUL ? 1 : 0);   // MUL por constante: soma de deslocamentos
+        if ((isCommutative(e->op) || isRelational(e->op)) && isSimpleOperand(e->a))
+            return nb;
+        const int direitoAntes = std::max(nb, na + 1);
+        if (isCommutative(e->op) || isRelational(e->op))
+            return std::min(direitoAntes, std::max(na, nb + 1));
+        return direitoAntes;
+    }
+    default:
+        return 0;
+    }
+}
+
+void CodeGeneratorBIP::generate(const AstNode* program) {
+    if (!program) return;
+
+    // parâmetros formais de todas as funções (chamadas podem vir antes)
+    for (const AstNode* n = program->a; n; n = n->next) {
+        if (n->kind != AstKind::Function) continue;
+        const std::string nome(n->name);
+        FuncInfo& f = funcoes_[n->sym];
+        f.label = labelId(nome == "main" ? "MAIN" : "FUNC_" + nome);
+        f.params.clear();
+        for (const AstNode* p = n->a; p; p = p->next)
+            f.params.push_back({ p->sym, dataId(nome + "_" + std::string(p->name)) });
+    }
+
+    // garante que a execução comece em MAIN
+    emitBranch(BipOp::JMP, labelId("MAIN"));
+
+    for (const AstNode* n = program->a; n; n = n->next)
+        genItem(n);
+
+    linkRuntime();
+    allocateTemps();
+    optimize();
+}
+
+const PeepholeStats& CodeGeneratorBIP::optimize() {
+    dadoUsado_.clear();
+    if (!opt_.peephole && !opt_.registerTracking && !opt_.deadCode)
+        return peephole_;
+
+    // portas: ler/escrever tem efeito colateral, nunca remover
+    const std::vector<int> volateis{ inPort_, outPort_ };
+    const int antes = static_cast<int>(code_.size());
+
+    const int rastreadas = opt_.registerTracking ? trackRegisters(code_, indr_, volateis) : 0;
+
+    if (opt_.peephole) {
+        peephole_ = peepholeOptimize(code_, volateis);
+    } else {
+        peephole_ = PeepholeStats();
+    }
+
+    DeadCodeStats mortas;
+    if (opt_.deadCode) {
+        mortas = eliminateDeadCode(code_, analysisVars());
+        // o que sobrou volta a casar com as regras (ex.: JMP para o rótulo seguinte)
+        if (opt_.peephole && mortas.removed() > 0) {
+            const PeepholeStats denovo = peepholeOptimize(code_, volateis);
+            for (std::size_t i = 0; i < denovo.perRule.size(); ++i)
+                peephole_.perRule[i].second += denovo.perRule[i].second;
+        }
+        dadoUsado_.assign(dados_.size(), 0);
+        for (const BipInstr& in : code_)
+            if (in.kind == BipOperand::Sym) dadoUsado_[in.arg] = 1;
+    }
+
+    peephole_.before = antes;
+    peephole_.after  = static_cast<int>(code_.size());
+    if (opt_.registerTracking)
+        peephole_.perRule.insert(peephole_.perRule.begin(), { "acc/$indr", rastreadas });
+    if (opt_.deadCode) {
+        peephole_.perRule.emplace_back("inalcançável", mortas.unreachable);
+        peephole_.perRule.emplace_back("sto-morto", mortas.deadStores);
+        peephole_.perRule.emplace_back("op-morta", mortas.deadOps);
+    }
+    return peephole_;
+}
+
+void CodeGeneratorBIP::genItem(const AstNode* n) {
+    if (n->kind == AstKind::Function)
+        genFunction(n);
+    else
+        genStmt(n);
+}
+
+void CodeGeneratorBIP::genFunction(const AstNode* f) {
+    const PosFonte pf(posFonte_, f->pos);
+    const FuncInfo* prev = currentFunction_;
+    auto it = funcoes_.find(f->sym);
+    currentFunction_ = it != funcoes_.end() ? &it->second : nullptr;
+    consts_.clear();                 // chamada de qualquer ponto
+
+    if (currentFunction_)
+        placeLabel(currentFunction_->label);
+    else
+        emitLabel(f->name == "main" ? std::string("MAIN") : "FUNC_" + std::string(f->name));
+
+    const AstNode* last = nullptr;
+    if (f->b) {
+        for (const AstNode* s = f->b->a; s; s = s->next) {
+            genStmt(s);
+            last = s;
+        }
+    }
+
+    // corpo sem "return" no final: retorna mesmo assim
+    if (!last || last->kind != AstKind::Return)
+        emitImm(BipOp::RETURN, 0);
+
+    consts_.clear();
+    currentFunction_ = prev;
+}
+
+void CodeGeneratorBIP::genDecl(const AstNode* d) {
+    const int dado = varSym(d);
+    const std::string nome(dados_.texto(dado));
+
+    if (d->isArray) {
+        long n = 0;
+        if (constInit(d->a, n) && n > 0)
+            setArraySize(nome, (int)n);
+
+        if (!d->c) return;
+
+        // lista { ... }: se for toda constante vai direto para a .data
+        std::vector<int> valores;
+        bool todosConst = true;
+        for (const AstNode* e = d->c->a; e; e = e->next) {
+            long v = 0;
+            if (!constInit(e, v)) { todosConst = false; break; }
+            valores.push_back((int)v);
+        }
+        if (todosConst) {
+            if (n <= 0) setArraySize(nome, (int)valores.size());
+            setArrayInitialValues(nome, valores);
+            return;
+        }
+
+        int k = 0;
+        for (const AstNode* e = d->c->a; e; e = e->next, ++k) {
+            genExpr(e, 0);
+            emitSym(BipOp::STO, temp(0));
+            emitImm(BipOp::LDI, k);
+            emitSym(BipOp::STO, indr_);
+            emitSym(BipOp::LD, temp(0));
+            emitSym(BipOp::STOV, dado);
+        }
+        return;
+    }
+
+    if (!d->b) return;
+
+    // global com literal: só valor inicial na .data
+    long v = 0;
+    if (!currentFunction_ && constInit(d->b, v)) {
+        setInitialValue(nome, (int)v);
+        return;
+    }
+
+    // local: inicializa a cada execução da declaração
+    const bool conhecido = foldConst(d->b, v);
+    genExpr(d->b, 0);
+    emitSym(BipOp::STO, dado);
+    if (conhecido && opt_.constantFolding) consts_[dado] = v;
+    else consts_.erase(dado);
+}
+
+void CodeGeneratorBIP::genStmt(const AstNode* n) {
+    if (!n) return;
+    const PosFonte pf(posFonte_, n->pos);
+
+    switch (n->kind) {
+    case AstKind::VarDecl:
+        if (!n->isParam) genDecl(n);
+        return;
+
+    case AstKind::Block:
+        for (const AstNode* s = n->a; s; s = s->next)
+            genStmt(s);
+        return;
+
+    case AstKind::Assign:
+        genStoreTo(n->a, n->b, 0);
+        return;
+
+    case AstKind::ExprStmt:
+        if (!n->a) return;
+        if (n->a->kind == AstKind::IncDec)
+            genIncDec(n->a, 0, false);
+        else if (n->a->kind == AstKind::Call)
+            genCall(n->a, 0);
+        else
+            genExpr(n->a, 0);
+        return;
+
+    case AstKind::If: {
+        int ifId = ifCounter_++;
+        const int elseLabel = labelId("_ELSE_IF_" + std::to_string(ifId));
+        const int endLabel = labelId("_END_IF_" + std::to_string(ifId));
+
+        // condição conhecida: só o ramo tomado
+        long v = 0;
+        if (foldConst(n->a, v) && opt_.constantFolding) {
+            genStmt(v ? n->b : n->c);
+            return;
+        }
+
+        genCondFalse(n->a, n->c ? elseLabel : endLabel, 0);
+        const auto antes = consts_;
+        genStmt(n->b);
+        if (n->c) {
+            const auto depoisEntao = consts_;
+            consts_ = antes;
+            emitBranch(BipOp::JMP, endLabel);
+            placeLabel(elseLabel);
+            genStmt(n->c);
+            intersect(consts_, depoisEntao);
+        } else {
+            intersect(consts_, antes);
+        }
+        placeLabel(endLabel);
+        return;
+    }
+
+    case AstKind::While: {
+        int loopId = loopCounter_++;
+        const int labelBegin = labelId("WHILE" + std::to_string(loopId));
+        const int labelEnd = labelId("ENDWHILE" + std::to_string(loopId));
+
+        forgetAssigned(n->a);
+        forgetAssigned(n->b);
+        long v = 0;
+        const bool conhecida = foldConst(n->a, v) && opt_.constantFolding;
+        if (conhecida && v == 0) return;           // while (0)
+
+        std::vector<LoopHoist> hs;
+        const AstNode* m = hoistLoop(n, hs);
+        if (opt_.loopRotation && !conhecida) {
+            // guarda + teste no fim: um desvio por volta em vez de dois
+            genCondFalse(n->a, labelEnd, 0);
+            emitPreheader(hs);
+            const auto guarda = consts_;
+            placeLabel(labelBegin);
+            genStmt(m->b);
+            genJump(m->a, labelBegin, true, 0);
+            placeLabel(labelEnd);
+            intersect(consts_, guarda);
+            return;
+        }
+
+        emitPreheader(hs);
+        placeLabel(labelBegin);
+        if (!conhecida) genCondFalse(m->a, labelEnd, 0);
+        const auto saida = consts_;
+        genStmt(m->b);
+        emitBranch(BipOp::JMP, labelBegin);
+        placeLabel(labelEnd);
+        consts_ = saida;
+        return;
+    }
+
+    case AstKind::DoWhile: {
+        int loopId = loopCounter_++;
+        const int labelBegin = labelId("DO" + std::to_string(loopId));
+        const int labelEnd = labelId("ENDDO" + std::to_string(loopId));
+
+        forgetAssigned(n->a);
+        forgetAssigned(n->b);
+        std::vector<LoopHoist> hs;
+        const AstNode* m = hoistLoop(n, hs);
+        emitPreheader(hs);
+        placeLabel(labelBegin);
+        genStmt(m->a);
+        long v = 0;
+        if (foldConst(n->b, v) && opt_.constantFolding) {
+            if (v) emitBranch(BipOp::JMP, labelBegin);   // do {} while (1)
+            placeLabel(labelEnd);
+            return;                                      // sai só pela condição
+        }
+        if (opt_.jumpingCode) {                          // volta enquanto verdadeira
+            genJump(m->b, labelBegin, true, 0);
+            return;
+        }
+        genCondFalse(m->b, labelEnd, 0);
+        emitBranch(BipOp::JMP, labelBegin);
+        placeLabel(labelEnd);
+        return;
+    }
+
+    case AstKind::For: {
+        int loopId = loopCounter_++;
+        const int labelBegin = labelId("FOR" + std::to_string(loopId));
+        const int labelEnd = labelId("ENDFOR" + std::to_string(loopId));
+
+        for (const AstNode* s = n->a; s; s = s->next)   // init pode ser lista
+            genStmt(s);
+
+        std::unordered_map<int, long> aposInit;
+        if (opt_.unrollBudget > 0) aposInit = consts_;
+        forgetAssigned(n->b);
+        forgetAssigned(n->c);
+        forgetAssigned(n->d);
+        long v = 0;
+        const bool conhecida = foldConst(n->b, v) && opt_.constantFolding;
+        if (conhecida && v == 0) return;           // nunca entra
+
+        long vezes = 0;
+        long u = 1;
+        if (opt_.unrollBudget > 0 && !conhecida && tripCount(n, aposInit, vezes)) {
+            const long custo = sizeEstimate(n->d) + sizeEstimate(n->c);
+            if (vezes * custo <= opt_.unrollBudget) {
+                // por completo: as voltas em sequência, sem desvios; i é
+                // conhecido em cada cópia e os STO intermediários morrem no DCE
+                consts_ = std::move(aposInit);
+                for (long k = 0; k < vezes; ++k) {
+                    genStmt(n->d);
+                    genStmt(n->c);
+                }
+                return;
+            }
+            u = 8;
+            while (u > 1 && (vezes % u != 0 || u * custo > opt_.unrollBudget)) --u;
+        }
+
+        std::vector<LoopHoist> hs;
+        const AstNode* m = hoistLoop(n, hs);
+        if (u > 1) {
+            // parcial: u cópias por volta, com u dividindo as voltas, então
+            // a condição só precisa ser testada no fim de cada grupo
+            emitPreheader(hs);
+            placeLabel(labelBegin);
+            for (long k = 0; k < u; ++k) {
+                genStmt(m->d);
+                genStmt(m->c);
+                emitInductionSteps(hs);
+            }
+            genJump(m->b, labelBegin, true, 0);
+            return;
+        }
+
+        if (opt_.loopRotation && !conhecida) {
+            genCondFalse(n->b, labelEnd, 0);
+            emitPreheader(hs);
+            const auto guarda = consts_;
+            placeLabel(labelBegin);
+            genStmt(m->d);
+            genStmt(m->c);
+            emitInductionSteps(hs);
+            genJump(m->b, labelBegin, true, 0);
+            placeLabel(labelEnd);
+            intersect(consts_, guarda);
+            return;
+        }
+
+        emitPreheader(hs);
+        placeLabel(labelBegin);
+        if (!conhecida) genCondFalse(m->b, labelEnd, 0);
+        const auto saida = consts_;
+        genStmt(m->d);
+        genStmt(m->c);
+        emitInductionSteps(hs);
+        emitBranch(BipOp::JMP, labelBegin);
+        placeLabel(labelEnd);
+        consts_ = saida;
+        return;
+    }
+
+    case AstKind::Return:
+        if (n->a) genExpr(n->a, 0);      // valor de retorno fica no ACC
+        emitImm(BipOp::RETURN, 0);
+        return;
+
+    case AstKind::Cin:
+        for (const AstNode* t = n->a; t; t = t->next) {
+            if (t->kind == AstKind::Index) {
+                genIndex(t->a, 0);
+                emitSym(BipOp::LD, inPort_);
+                emitSym(BipOp::STOV, varSym(t));
+            } else {
+                emitSym(BipOp::LD, inPort_);
+                emitSym(BipOp::STO, varSym(t));
+                consts_.erase(varSym(t));
+            }
+        }
+        return;
+
+    case AstKind::Cout:
+        for (const AstNode* e = n->a; e; e = e->next)
+            genCoutItem(e);
+        return;
+
+    default:
+        genExpr(n, 0);
+        return;
+    }
+}
+
+// "cout << a << b" chega como cout << (a << b): o parser prefere o
+// deslocamento, então desfaz a cadeia de "<<" em várias saídas
+void CodeGeneratorBIP::genCoutItem(const AstNode* e) {
+    if (e->kind == AstKind::Binary && e->op == t_OPBB_DE) {
+        genCoutItem(e->a);
+        genCoutItem(e->b);
+        return;
+    }
+    genExpr(e, 0);
+    emitSym(BipOp::STO, outPort_);
+}
+
+// índice de vetor -> $indr
+void CodeGeneratorBIP::genIndex(const AstNode* idx, int t) {
+    genExpr(idx, t);
+    emitSym(BipOp::STO, indr_);
+}
+
+// destino (Id ou Index) <- valor
+void CodeGeneratorBIP::genStoreTo(const AstNode* target, const AstNode* value, int t) {
+    if (target->kind == AstKind::Id) {
+        const int dado = varSym(target);
+        long v = 0;
+        const bool conhecido = foldConst(value, v) && opt_.constantFolding;
+        genExpr(value, t);
+        emitSym(BipOp::STO, dado);
+        if (conhecido) consts_[dado] = v;
+        else consts_.erase(dado);
+        return;
+    }
+
+    const int arr = varSym(target);
+
+    // valor que não mexe em $indr: fixa o índice primeiro
+    if (isSimpleOperand(value) || value->kind == AstKind::OtherLit ||
+        (opt_.sethiUllman && !touchesIndr(value) &&
+         !hasSideEffects(value) && !hasSideEffects(target->a))) {
+        genIndex(target->a, t);
+        genExpr(value, t);
+        emitSym(BipOp::STOV, arr);
+        return;
+    }
+
+    // valor composto: calcula, guarda e só depois fixa o índice
+    const int tmp = temp(t);
+    genExpr(value, t);
+    emitSym(BipOp::STO, tmp);
+    genIndex(target->a, t + 1);
+    emitSym(BipOp::LD, tmp);
+    emitSym(BipOp::STOV, arr);
+}
+
+// chamada com passagem por cópia: FUNC_param = arg; CALL FUNC_nome
+void CodeGeneratorBIP::genCall(const AstNode* c, int t) {
+    if (c->name == "main") return;   // não faz CALL main
+
+    auto it = funcoes_.find(c->sym);
+    if (it == funcoes_.end()) {
+        emitBranch(BipOp::CALL, labelId("FUNC_" + std::string(c->name)));
+        consts_.clear();
+        return;
+    }
+
+    const FuncInfo& f = it->second;
+    size_t k = 0;
+    for (const AstNode* a = c->a; a && k < f.params.size(); a = a->next, ++k) {
+        genExpr(a, t);
+        emitSym(BipOp::STO, f.params[k].data);
+    }
+
+    emitBranch(BipOp::CALL, f.label);
+    consts_.clear();                 // a função pode alterar qualquer global
+}
+
+// ++/-- em variável ou elemento de vetor
+void CodeGeneratorBIP::genIncDec(const AstNode* e, int t, bool wantValue) {
+    const BipOp op = (e->op == t_OPA_SUM1) ? BipOp::ADDI : BipOp::SUBI;
+    const AstNode* alvo = e->a;
+    bool vetor = alvo->kind == AstKind::Index;
+    const int nome = varSym(alvo);
+
+    if (vetor) {
+        genIndex(alvo->a, t);
+        emitSym(BipOp::LDV, nome);
+    } else {
+        emitSym(BipOp::LD, nome);
+    }
+
+    // pós-fixado usado como valor: guarda o valor antigo
+    bool guarda = wantValue && !e->prefix;
+    if (guarda) emitSym(BipOp::STO, temp(t));
+
+    emitImm(op, 1);
+    emitSym(vetor ? BipOp::STOV : BipOp::STO, nome);
+
+    if (!vetor) {
+        auto it = consts_.find(nome);
+        if (it != consts_.end())
+            it->second = wrap16(it->second + (op == BipOp::ADDI ? 1 : -1));
+    }
+
+    if (guarda) emitSym(BipOp::LD, temp(t));
+}
+
+// avalia a expressão no ACC; __TMPt.. são livres para uso
+void CodeGeneratorBIP::genExpr(const AstNode* e, int t) {
+    if (!e) return;
+
+    long k = 0;
+    if (e->kind != AstKind::IntLit && opt_.constantFolding && foldConst(e, k)) {
+        emitImm(BipOp::LDI, k);
+        return;
+    }
+
+    switch (e->kind) {
+    case AstKind::IntLit:
+        emitImm(BipOp::LDI, e->value);
+        return;
+
+    case AstKind::OtherLit:
+        // float/string não existem na BIP
+        emitImm(BipOp::LDI, 0);
+        return;
+
+    case AstKind::Id:
+        emitSym(BipOp::LD, varSym(e));
+        return;
+
+    case AstKind::Index:
+        genIndex(e->a, t);
+        emitSym(BipOp::LDV, varSym(e));
+        return;
+
+    case AstKind::Call:
+        genCall(e, t);                // retorno fica no ACC
+        return;
+
+    case AstKind::IncDec:
+        genIncDec(e, t, true);
+        return;
+
+    case AstKind::Unary:
+        if (e->op == t_OPA_SUB) {
+            if (e->a->kind == AstKind::IntLit) {
+                emitImm(BipOp::LDI, -e->a->value);
+                return;
+            }
+            if (opt_.sethiUllman) {          // sem __TMP: -x = ~x + 1
+                genExpr(e->a, t);
+                emitNegate();
+                return;
+            }
+            const int tmp = temp(t);
+            genExpr(e->a, t);
+            emitSym(BipOp::STO, tmp);
+            emitImm(BipOp::LDI, 0);
+            emitSym(BipOp::SUB, tmp);
+            return;
+        }
+        if (e->op == t_OPBB_NOT) {
+            genExpr(e->a, t);
+            emitNot();
+            return;
+        }
+        if (e->op == t_OPL_DIFF) {
+            genBool(e, t);
+            return;
+        }
+        genExpr(e->a, t);             // '+' unário
+        return;
+
+    case AstKind::Binary: {
+        if (isRelational(e->op) || isLogical(e->op)) {
+            genBool(e, t);
+            return;
+        }
+        BipOp direta, imediata;
+        if (!binaryOps(e->op, direta, imediata)) return;
+
+        if (opt_.constantFolding) {
+            // direito constante: "OPI k", ou nada quando é o elemento neutro
+            // (se o esquerdo chama função, o valor de k pode mudar no meio)
+            if (!hasSideEffects(e->a) && foldConst(e->b, k)) {
+                if (isAbsorbing(e->op, k)) {
+                    emitImm(BipOp::LDI, 0);
+                    return;
+                }
+                genExpr(e->a, t);
+                if (!isIdentity(e->op, k)) emitArith(e->op, BipOperand::Imm, k, t);
+                return;
+            }
+            // comutativo com esquerdo constante/simples: troca os lados e
+            // evita o __TMP (o valor de um esquerdo dobrado só vale se o
+            // direito não chama função)
+            const bool esqConst = foldConst(e->a, k) &&
+                                  (e->a->kind == AstKind::IntLit || !hasSideEffects(e->b));
+            if (isCommutative(e->op) && !isSimpleOperand(e->b) &&
+                (isSimpleOperand(e->a) || esqConst)) {
+                if (esqConst && isAbsorbing(e->op, k) && !hasSideEffects(e->b)) {
+                    emitImm(BipOp::LDI, 0);
+                    return;
+                }
+                genExpr(e->b, t);
+                if (!esqConst)                  emitArith(e->op, BipOperand::Sym, varSym(e->a), t);
+                else if (!isIdentity(e->op, k)) emitArith(e->op, BipOperand::Imm, k, t);
+                return;
+            }
+        }
+
+        // Sethi–Ullman: comutativo com esquerdo simples entra direto na
+        // instrução; com os dois compostos, o que ocupa mais __TMP vai antes
+        if (opt_.sethiUllman && isCommutative(e->op) && !isSimpleOperand(e->b)) {
+            if (isSimpleOperand(e->a)) {
+                genExpr(e->b, t);
+                if (e->a->kind == AstKind::IntLit)
+                    emitArith(e->op, BipOperand::Imm, e->a->value, t);
+                else
+                    emitArith(e->op, BipOperand::Sym, varSym(e->a), t);
+                return;
+            }
+            if (!hasSideEffects(e->a) && !hasSideEffects(e->b) &&
+                tempsNeeded(e->a) > tempsNeeded(e->b)) {
+                const int tmp = temp(t);
+                genExpr(e->a, t);
+                emitSym(BipOp::STO, tmp);
+                genExpr(e->b, t + 1);
+                emitArith(e->op, BipOperand::Sym, tmp, t + 1);
+                return;
+            }
+        }
+
+        // operando direito simples: "OP x" / "OPI k"
+        if (isSimpleOperand(e->b)) {
+            genExpr(e->a, t);
+            if (e->b->kind == AstKind::IntLit) {
+                emitArith(e->op, BipOperand::Imm, e->b->value, t);
+            } else {
+                emitArith(e->op, BipOperand::Sym, varSym(e->b), t);
+            }
+            return;
+        }
+
+        // direito composto: avalia primeiro e guarda em __TMPt
+        const int tmp = temp(t);
+        genExpr(e->b, t);
+        emitSym(BipOp::STO, tmp);
+        genExpr(e->a, t + 1);
+        emitArith(e->op, BipOperand::Sym, tmp, t + 1);
+        return;
+    }
+
+    default:
+        return;
+    }
+}
+
+// materializa o valor lógico (0/1) de relacionais, &&, || e !
+void CodeGeneratorBIP::genBool(const AstNode* e, int t) {
+    const int lblFalse = newLabelId("_BOOL_F");
+    const int lblEnd = newLabelId("_BOOL_E");
+
+    if (opt_.jumpingCode) {
+        genCondFalse(e, lblFalse, t);
+        emitImm(BipOp::LDI, 1);
+        emitBranch(BipOp::JMP, lblEnd);
+        placeLabel(lblFalse);
+        emitImm(BipOp::LDI, 0);
+        placeLabel(lblEnd);
+        return;
+    }
+
+    if (e->kind == AstKind::Unary && e->op == t_OPL_DIFF) {
+        // !x -> 1 quando x == 0
+        genExpr(e->a, t);
+        emitBranch(BipOp::JZ, lblFalse);
+        emitImm(BipOp::LDI, 0);
+        emitBranch(BipOp::JMP, lblEnd);
+        placeLabel(lblFalse);
+        emitImm(BipOp::LDI, 1);
+        placeLabel(lblEnd);
+        return;
+    }
+
+    if (e->op == t_OPL_AND) {
+        genExpr(e->a, t);
+        emitBranch(BipOp::JZ, lblFalse);
+        genExpr(e->b, t);
+        forgetAssigned(e->b);        // nem sempre avaliado
+        emitBranch(BipOp::JZ, lblFalse);
+    } else if (e->op == t_OPL_OR) {
+        const int lblTrue = newLabelId("_BOOL_T");
+        const int lblNext = newLabelId("_BOOL_N");
+        genExpr(e->a, t);
+        emitBranch(BipOp::JZ, lblNext);
+        emitBranch(BipOp::JMP, lblTrue);
+        placeLabel(lblNext);
+        genExpr(e->b, t);
+        forgetAssigned(e->b);
+        emitBranch(BipOp::JZ, lblFalse);
+        placeLabel(lblTrue);
+    } else {
+        genCondFalse(e, lblFalse, t);
+    }
+
+    emitImm(BipOp::LDI, 1);
+    emitBranch(BipOp::JMP, lblEnd);
+    placeLabel(lblFalse);
+    emitImm(BipOp::LDI, 0);
+    placeLabel(lblEnd);
+}
+
+// desvia para falseLabel quando a condição é falsa
+void CodeGeneratorBIP::genCondFalse(const AstNode* c, int falseLabel, int t) {
+    genJump(c, falseLabel, false, t);
+}
+
+// Desvia para 'label' quando a condição vale 'quando'. Com jumpingCode,
+// &&, || e ! viram cadeias de desvios (cada operando só é avaliado se
+// ainda decide o resultado) e nenhum 0/1 é materializado; sem, só o
+// relacional direto escapa de avaliar a condição no ACC.
+void CodeGeneratorBIP::genJump(const AstNode* c, int label, bool quando, int t) {
+    if (!c) {                                   // for(;;): sempre verdadeira
+        if (quando) emitBranch(BipOp::JMP, label);
+        return;
+    }
+
+    auto desvio = [&](int op) { return quando ? branchIfTrue(op) : branchIfFalse(op); };
+
+    long k = 0;
+    if (opt_.constantFolding) {
+        if (foldConst(c, k)) {
+            if ((k != 0) == quando) emitBranch(BipOp::JMP, label);
+            return;
+        }
+    }
+
+    if (opt_.jumpingCode) {
+        if (c->kind == AstKind::Unary && c->op == t_OPL_DIFF) {
+            genJump(c->a, label, !quando, t);
+            return;
+        }
+        if (c->kind == AstKind::Binary && isLogical(c->op)) {
+            // "a && b" é falsa se a for; "a || b" é verdadeira se a for
+            const bool e = c->op == t_OPL_AND;
+            if (quando != e) {
+                genJump(c->a, label, quando, t);
+                genJump(c->b, label, quando, t);
+            } else {
+                const int decidido = newLabelId(e ? "_AND_" : "_OR_");
+                genJump(c->a, decidido, !quando, t);
+                genJump(c->b, label, quando, t);
+                placeLabel(decidido);
+            }
+            forgetAssigned(c->b);               // nem sempre avaliado
+            return;
+        }
+    }
+
+    if (opt_.constantFolding) {
+        if (c->kind == AstKind::Binary && isRelational(c->op)) {
+            // "x op k": SUBI direto, mesmo que k venha de uma expressão
+            if (!hasSideEffects(c->a) && foldConst(c->b, k)) {
+                genExpr(c->a, t);
+                emitImm(BipOp::SUBI, k);
+                emitBranch(desvio(c->op), label);
+                return;
+            }
+            // "k op expr" / "x op expr": inverte para não gastar __TMP
+            const bool esqConst = foldConst(c->a, k) &&
+                                  (c->a->kind == AstKind::IntLit || !hasSideEffects(c->b));
+            if (!isSimpleOperand(c->b) && (esqConst || isSimpleOperand(c->a))) {
+                genExpr(c->b, t);
+                if (esqConst) emitImm(BipOp::SUBI, k);
+                else          emitSym(BipOp::SUB, varSym(c->a));
+                emitBranch(desvio(mirrorRelational(c->op)), label);
+                return;
+            }
+        }
+    }
+
+    // Sethi–Ullman, como em genExpr: "a op b" == "b op' a"
+    if (opt_.sethiUllman && c->kind == AstKind::Binary && isRelational(c->op) &&
+        !isSimpleOperand(c->b)) {
+        if (isSimpleOperand(c->a)) {
+            genExpr(c->b, t);
+            if (c->a->kind == AstKind::IntLit) emitImm(BipOp::SUBI, c->a->value);
+            else                               emitSym(BipOp::SUB, varSym(c->a));
+            emitBranch(desvio(mirrorRelational(c->op)), label);
+            return;
+        }
+        if (!hasSideEffects(c->a) && !hasSideEffects(c->b) &&
+            tempsNeeded(c->a) > tempsNeeded(c->b)) {
+            const int tmp = temp(t);
+            genExpr(c->a, t);
+            emitSym(BipOp::STO, tmp);
+            genExpr(c->b, t + 1);
+            emitSym(BipOp::SUB, tmp);
+            emitBranch(desvio(mirrorRelational(c->op)), label);
+            return;
+        }
+    }
+
+    if (c->kind == AstKind::Binary && isRelational(c->op)) {
+        if (isSimpleOperand(c->b)) {
+            genExpr(c->a, t);
+            if (c->b->kind == AstKind::IntLit)
+                emitImm(BipOp::SUBI, c->b->value);
+            else
+                emitSym(BipOp::SUB, varSym(c->b));
+        } else {
+            const int tmp = temp(t);
+            genExpr(c->b, t);
+            emitSym(BipOp::STO, tmp);
+            genExpr(c->a, t + 1);
+            emitSym(BipOp::SUB, tmp);
+        }
+        emitBranch(desvio(c->op), label);
+        return;
+    }
+
+    // condição genérica: valor no ACC, zero = falso
+    genExpr(c, t);
+    if (quando) {
+        emitImm(BipOp::SUBI, 0);                // STATUS = ACC
+        emitBranch(BipOp::BNE, label);
+    } else {
+        emitBranch(BipOp::JZ, label);
+    }
+}
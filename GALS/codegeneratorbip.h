@@ -2,7 +2,17 @@
 #define CODEGENERATOR_BIP_H
 
 #include "Semantico.h"   // precisa do tipo Simbolo
+#include "ast.h"
+#include "bipcfg.h"
+#include "bipir.h"
+#include "bipruntime.h"
+#include "deadcode.h"
+#include "interner.h"
+#include "peephole.h"
+#include "regtrack.h"
+#include "temppool.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 #include <functional>
@@ -24,6 +34,20 @@ public:
         std::string entryLabel;      // ex.: "_PRINCIPAL"
         std::string textComment;
 
+        // otimização
+        bool        peephole;        // passada peephole ao fim de generate()
+        bool        registerTracking; // elimina recargas de ACC/$indr (regtrack.h)
+        bool        constantFolding; // dobra/propaga constantes durante generate()
+        bool        deadCode;        // remove código inalcançável/morto e a .data sem uso (deadcode.h)
+        bool        sethiUllman;     // ordem de avaliação com menos __TMP e pool de __TMPn (temppool.h)
+        bool        jumpingCode;     // &&, || e ! em condições como cadeias de desvios
+        bool        loopRotation;    // while/for testados no fim, com um teste de guarda na entrada
+        int         unrollBudget;    // instruções (estimadas) para desenrolar for de voltas conhecidas; 0 = não
+        bool        loopInvariants;  // LICM e "i * c" incremental nos laços
+
+        // depuração
+        bool        dumpCfg;         // Compilador preenche ResultadoCompilacao::cfgDot
+
         Options()
             : includeDataHeader(true)
             , sortByName(true)
@@ -31,17 +55,31 @@ public:
             , includeTextHeader(true)
             , entryLabel("_PRINCIPAL")
             , textComment(";")
+            , peephole(true)
+            , registerTracking(true)
+            , constantFolding(true)
+            , deadCode(true)
+            , sethiUllman(true)
+            , jumpingCode(true)
+            , loopRotation(true)
+            , unrollBudget(64)
+            , loopInvariants(true)
+            , dumpCfg(false)
         {}
     };
 
     explicit CodeGeneratorBIP(const Options& opt = Options());
 
+    // IR emitida até agora (base para as passadas de otimização)
+    const std::vector<BipInstr>& code() const { return code_; }
+    void renderInstr(const BipInstr& in, std::string& out) const;
+
     // ========= .data =========
     std::string buildDataSection(const std::vector<Simbolo>& tabela) const;
 
     // ========= .text – API de emissão =========
     void clearText();                               // limpa buffer de texto
-    void emitInstr(const std::string& instr);       // emite linha crua
+    void emitInstr(const std::string& instr);       // emite linha "MNEMÔNICO [operando]"
     void emitLabel(const std::string& label);       // rótulo "L1:"
     std::string newLabel(const std::string& prefix ="L"); // gera Lx único
 
@@ -56,8 +94,10 @@ public:
     // Aritmética (topo da pilha / acumulador da BIP):
     void emitAdd();                                 // ADD
     void emitSub();                                 // SUB
-    void emitMul();                                 // MUL
-    void emitDiv();                                 // DIV
+    // a BIP não tem MUL/DIV: deslocamentos ou CALL __MUL/__DIV/__MOD
+    void emitMul(const std::string& operando);      // ACC *= literal/variável
+    void emitDiv(const std::string& operando);      // ACC /= literal/variável
+    void emitMod(const std::string& operando);      // ACC %= literal/variável
 
     // Bit a bit:
     void emitAnd();                                 // AND
@@ -83,8 +123,32 @@ public:
                               const std::string& oper,
                               const std::string& op2);
 
+    // ========= Geração a partir da AST =========
+    // Percorre a árvore montada pelo Sintatico e emite todo o .text
+    // (inclui o "JMP MAIN" inicial). Uma única passada, sem reparse.
+    void generate(const AstNode* program);
+
+    // Acrescenta ao fim do .text as rotinas de bipruntime.h chamadas até
+    // agora (generate() já chama; necessário só com a API de emissão)
+    void linkRuntime();
+
+    // Passadas de otimização habilitadas em Options, sobre a IR
+    // (generate() já chama no fim)
+    const PeepholeStats& optimize();
+    const PeepholeStats& peepholeStats() const { return peephole_; }
+
+    // ========= Análises (bipcfg.h) =========
+    BipVars     analysisVars() const;     // ids de dado + ACC/STATUS
+    std::string varName(int var) const;   // nome de uma variável de BipVars
+    // CFG da IR atual em Graphviz, com as variáveis vivas em cada bloco
+    std::string cfgDot() const;
+
     // ========= Programa completo =========
+    // .text é renderizada a partir da IR só aqui
     std::string buildTextSection() const;
+    // mapa do fonte: por linha de buildTextSection(), a posição no fonte
+    // (AstNode::pos) do comando que gerou a instrução, ou -1
+    std::vector<int> textSourcePositions() const;
     std::string buildProgram(const std::vector<Simbolo>& tabela) const;
 
     // ========= utilitários =========
@@ -100,9 +164,30 @@ public:
 
 private:
     Options opt_;
-    std::vector<std::string> text_;
     mutable int labelCounter_ = 0;
 
+    // ===== IR do .text =====
+    std::vector<BipInstr>    code_;
+    Interner                 dados_;     // operandos de memória (rótulos da .data, $indr, portas)
+    Interner                 rotulos_;   // rótulos de código
+    std::vector<std::string> raw_;       // linhas que emitInstr não reconheceu
+    int indr_ = -1, inPort_ = -1, outPort_ = -1;
+    PeepholeStats            peephole_;
+    std::vector<char>        dadoUsado_; // por id de dado, após deadCode; vazio = .data completa
+
+    int posFonte_ = -1;                    // AstNode::pos do comando sendo emitido
+
+    void push(BipInstr in)                 { in.pos = posFonte_; code_.push_back(in); }
+    void emit(BipOp op)                    { push({ op, BipOperand::None, 0 }); }
+    void emitImm(BipOp op, long v)         { push({ op, BipOperand::Imm, v }); }
+    void emitSym(BipOp op, int dado)       { push({ op, BipOperand::Sym, dado }); }
+    void emitBranch(BipOp op, int rotulo)  { push({ op, BipOperand::Label, rotulo }); }
+    void placeLabel(int rotulo)            { push({ BipOp::Label, BipOperand::Label, rotulo }); }
+
+    int dataId(const std::string& nome);   // sanitiza e interna
+    int labelId(const std::string& nome);
+    int newLabelId(const char* prefix);    // como newLabel, já como id
+
     static bool        isGlobalDataCandidate(const Simbolo& s);
 
     static std::string sanitizeLabel(const std::string& s);
@@ -112,6 +197,93 @@ private:
     std::unordered_map<std::string, std::vector<int>> arrayInitialValues_;
 
     std::unordered_map<std::string, int> arraySizes_;
+
+    // ===== estado da geração a partir da AST =====
+    // nomes chegam como ids do Interner (AstNode::sym); os rótulos são
+    // sanitizados uma vez por nome e reaproveitados em todas as ocorrências
+    struct ParamInfo {
+        int sym;                           // id do nome do parâmetro
+        int data;                          // dado "func_param"
+    };
+    struct FuncInfo {
+        int                    label;      // rótulo "FUNC_nome" (ou MAIN)
+        std::vector<ParamInfo> params;     // na ordem da declaração
+    };
+    std::unordered_map<int, FuncInfo> funcoes_;   // id do nome da função -> assinatura
+    const FuncInfo* currentFunction_ = nullptr;   // função sendo emitida (nullptr = global)
+    std::vector<int> labels_;              // id do nome -> dado (-1 = ainda não visto)
+    std::vector<int> temps_;               // k -> dado __TMPk
+    // com sethiUllman: __TMPk de cada função, até allocateTemps() escolher o slot
+    struct TempVirtual {
+        int dado;
+        int k;                             // profundidade (slot se o CFG não fechar; -1 = __INVk)
+    };
+    std::vector<TempVirtual>                tempsVirtuais_;
+    std::unordered_map<long long, int>      tempVirtualDe_;  // (rótulo da função, k) -> índice
+    int loopCounter_ = 0;
+    int ifCounter_   = 0;
+    int tempCount_   = 1;                  // quantos __TMPn a .data precisa
+
+    // propagação de constantes: dado escalar -> valor conhecido no ponto
+    // atual da emissão (vale só em código linear; ver forgetAssigned)
+    std::unordered_map<int, long> consts_;
+
+    int symData(int sym, std::string_view nome);
+    int varSym(const AstNode* n);          // aplica o "mangling" de parâmetros
+    int temp(int k);                       // __TMP da profundidade k
+    int physicalTemp(int k);               // __TMPk
+    int tempsNeeded(const AstNode* e);     // __TMPs que genExpr(e) ocupa
+    void allocateTemps();
+
+    // ACC = ACC op operando (dado ou imediato, conforme 'kind')
+    void emitArith(int op, BipOperand kind, long arg, int t);
+    void emitMulDiv(int op, BipOperand kind, long arg, int t);
+    void emitCallRoutine(BipRoutine r, BipOperand kind, long arg);
+    void emitNegate();                     // ACC = -ACC
+    unsigned rotinas_ = 0;                 // rotinas de bipruntime.h chamadas (bipRoutineBit)
+    unsigned linkadas_ = 0;                // ... e já acrescentadas ao .text
+
+    bool foldConst(const AstNode* e, long& v);     // valor em tempo de compilação
+    void forgetAssigned(const AstNode* n);         // esquece o que n pode escrever
+    bool mayAssign(const AstNode* n, int dado);    // n pode escrever o escalar 'dado'
+    bool tripCount(const AstNode* f, const std::unordered_map<int, long>& aposInit, long& vezes);
+
+    // LICM / variáveis de indução (loopInvariants): o valor é calculado num
+    // __INVk antes da primeira volta e lido no lugar da expressão no laço
+    struct LoopHoist {
+        const AstNode* expr;               // expressão original (pré-cabeçalho)
+        int            dado;               // __INVk
+        long           passo;              // indução: somado a cada passo do for (0 = invariante)
+    };
+    struct HoistCtx {
+        const AstNode*          partes[3]; // o que repete a cada volta
+        int                     np = 0;
+        int                     iv = -1;   // variável de indução do for (dado) ...
+        long                    ivPasso = 0;   // ... e quanto o passo soma
+        std::vector<LoopHoist>* hs = nullptr;
+    };
+    std::deque<AstNode> sinteticos_;       // cópias reescritas da AST (estáveis)
+    std::vector<int>    invs_;             // __INVk que ficam com nome próprio na .data
+    int                 invCount_ = 0;
+    const AstNode* hoistLoop(const AstNode* n, std::vector<LoopHoist>& hs);
+    AstNode* hoistIn(const AstNode* n, HoistCtx& cx);
+    bool loopInvariant(const AstNode* e, const HoistCtx& cx);
+    void emitPreheader(const std::vector<LoopHoist>& hs);
+    void emitInductionSteps(const std::vector<LoopHoist>& hs);
+
+    void genItem(const AstNode* n);
+    void genFunction(const AstNode* f);
+    void genStmt(const AstNode* n);
+    void genDecl(const AstNode* d);
+    void genExpr(const AstNode* e, int t);
+    void genCall(const AstNode* c, int t);
+    void genIndex(const AstNode* idx, int t);      // índice -> $indr
+    void genCondFalse(const AstNode* c, int falseLabel, int t);
+    void genJump(const AstNode* c, int label, bool quando, int t);   // desvia se c == quando
+    void genBool(const AstNode* e, int t);         // materializa 0/1 no ACC
+    void genIncDec(const AstNode* e, int t, bool wantValue);
+    void genStoreTo(const AstNode* target, const AstNode* value, int t);
+    void genCoutItem(const AstNode* e);
 };
 
 #endif // CODEGENERATOR_BIP_H
@@ -0,0 +1,139 @@
+#include "compilador.h"
+
+#include "Lexico.h"
+#include "Sintatico.h"
+#include "LexicalError.h"
+#include "SyntacticError.h"
+#include "SemanticError.h"
+#include "CancelledError.h"
+#include "ast.h"
+
+#include <algorithm>
+
+// linha do fonte de cada linha do assembly, a partir das posições do .text
+static std::vector<int> mapaDoFonte(const std::string& fonte, const std::string& dados,
+                                    const std::vector<int>& posicoes)
+{
+    std::vector<int> inicioLinha{ 0 };
+    for (std::size_t i = 0; i < fonte.size(); ++i)
+        if (fonte[i] == '\n') inicioLinha.push_back(static_cast<int>(i + 1));
+
+    std::vector<int> mapa(std::count(dados.begin(), dados.end(), '\n'), 0);
+    mapa.reserve(mapa.size() + posicoes.size());
+    for (int p : posicoes) {
+        if (p < 0) { mapa.push_back(0); continue; }
+        mapa.push_back(static_cast<int>(std::upper_bound(inicioLinha.begin(), inicioLinha.end(), p)
+                                        - inicioLinha.begin()));
+    }
+    return mapa;
+}
+
+ResultadoCompilacao Compilador::compilar(const std::string& fonte) const
+{
+    ResultadoCompilacao r;
+
+    Lexico     lex;
+    Sintatico  sint;
+    Semantico  sem;
+    AstBuilder ast;   // AST montada durante o parse (usada pelo gerador)
+
+    CodeGeneratorBIP gen(opt_);
+    sem.setCodeGenerator(&gen);
+
+    // um único Interner por compilação: o léxico numera os identificadores
+    // e as demais fases comparam só os ids
+    lex.setInput(fonte.c_str());
+    sem.setInterner(&lex.interner());
+    ast.setInterner(&lex.interner());
+    sint.setCancelamento(cancelar_);
+
+    sem.clearMensagens();
+    if (logger_)
+        sem.setLogger(logger_);
+
+    // 1) Fase de análise (léxica/sintática/semântica)
+    try {
+        sint.parse(&lex, &sem, &ast);
+    }
+    catch (const LexicalError &err) {
+        r.etapa = ResultadoCompilacao::Etapa::ErroLexico;
+        r.erro = err.getMessage();
+        r.posicao = err.getPosition();
+    }
+    catch (const SyntacticError &err) {
+        r.etapa = ResultadoCompilacao::Etapa::ErroSintatico;
+        r.erro = err.getMessage();
+        r.posicao = err.getPosition();
+    }
+    catch (const SemanticError &err) {
+        r.etapa = ResultadoCompilacao::Etapa::ErroSemantico;
+        r.erro = err.getMessage();
+        r.posicao = err.getPosition();
+    }
+    catch (const CancelledError &err) {
+        r.etapa = ResultadoCompilacao::Etapa::Cancelada;
+        r.erro = err.getMessage();
+    }
+
+    if (!r.ok()) {
+        r.mensagens = sem.mensagens();
+        return r;   // NÃO segue para geração de ASM
+    }
+
+    // 2) Se o semântico marcou erros "fatais", não gera ASM
+    if (sem.temErro()) {
+        r.etapa = ResultadoCompilacao::Etapa::ErrosMarcados;
+        r.mensagens = sem.mensagens();
+        return r;
+    }
+
+    if (cancelado()) {
+        r.etapa = ResultadoCompilacao::Etapa::Cancelada;
+        return r;
+    }
+
+    // 3) Geração do .text percorrendo a AST (começa com "JMP MAIN")
+    gen.generate(ast.root());
+    r.peephole = gen.peepholeStats();
+
+    // Marca 'main' como usada (ponto de entrada)
+    for (auto& s : sem.tabelaSimbolo) {
+        if (s.nome == "main" && s.modalidade == Modalidade::Funcao) {
+            s.usado = true;
+            break;
+        }
+    }
+
+    sem.verificarNaoUsados();
+
+    r.mensagens = sem.mensagens();
+    r.simbolos  = sem.tabelaSimbolo;
+
+    // Cópia da tabela incluindo parâmetros "manglados":
+    // para cada parâmetro usado, cria um global FUNC_param
+    r.tabelaFinal = sem.tabelaSimbolo;
+    for (const auto &s : sem.tabelaSimbolo) {
+        if (s.modalidade == Modalidade::Parametro && s.usado) {
+            Simbolo novo = s;
+
+            novo.nome       = nomeEscopo(sem.tabelaSimbolo, s) + "_" + s.nome;   // escopo = função dona
+            novo.nomeId     = Interner::NENHUM;          // nome composto, fora do Interner
+            novo.escopo     = ESCOPO_GLOBAL;
+            novo.modalidade = Modalidade::Variavel;
+
+            r.tabelaFinal.push_back(novo);
+        }
+    }
+
+    if (cancelado()) {
+        r.etapa = ResultadoCompilacao::Etapa::Cancelada;
+        return r;
+    }
+
+    const std::string dados = gen.buildDataSection(r.tabelaFinal);
+    r.assembly = dados + gen.buildTextSection();
+    r.linhaFonte = mapaDoFonte(fonte, dados, gen.textSourcePositions());
+    if (opt_.dumpCfg)
+        r.cfgDot = gen.cfgDot();
+    return r;
+}
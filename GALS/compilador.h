@@ -0,0 +1,64 @@
+#ifndef COMPILADOR_H
+#define COMPILADOR_H
+
+#include "Semantico.h"
+#include "codegeneratorbip.h"
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Resultado de uma compilação completa (léxico -> sintático -> semântico -> BIP)
+struct ResultadoCompilacao {
+    enum class Etapa {
+        Sucesso,
+        ErroLexico,
+        ErroSintatico,
+        ErroSemantico,     // SemanticError lançado durante o parse
+        ErrosMarcados,     // o semântico registrou erros; assembly não gerado
+        Cancelada          // a flag de cancelamento foi ligada no meio
+    };
+
+    Etapa       etapa   = Etapa::Sucesso;
+    std::string erro;          // mensagem do erro (etapas de erro)
+    int         posicao = -1;  // posição do erro no fonte
+
+    std::vector<std::string> mensagens;   // avisos/erros do semântico, em ordem
+
+    std::vector<Simbolo> simbolos;        // tabela do semântico
+    std::vector<Simbolo> tabelaFinal;     // + parâmetros usados como globais "func_param"
+
+    std::string assembly;                 // .data + .text
+    std::vector<int> linhaFonte;          // por linha do assembly: linha do fonte (1..), 0 = nenhuma
+    PeepholeStats peephole;               // instruções economizadas pelas otimizações
+    std::string cfgDot;                   // CFG em Graphviz (Options::dumpCfg)
+
+    bool ok() const { return etapa == Etapa::Sucesso; }
+};
+
+// Pipeline sem dependência de Qt: usado pela IDE e pelo miniidec.
+// Cada instância é independente; instâncias distintas podem rodar em
+// threads diferentes ao mesmo tempo.
+class Compilador {
+public:
+    explicit Compilador(const CodeGeneratorBIP::Options& opt = CodeGeneratorBIP::Options())
+        : opt_(opt) { }
+
+    // recebe cada mensagem do semântico assim que é emitida
+    void setLogger(std::function<void(const std::string&)> fn) { logger_ = std::move(fn); }
+
+    // cancelamento cooperativo: consultado durante o parse e entre as fases
+    void setCancelamento(const std::atomic<bool>* flag) { cancelar_ = flag; }
+
+    ResultadoCompilacao compilar(const std::string& fonte) const;
+
+private:
+    bool cancelado() const { return cancelar_ && cancelar_->load(std::memory_order_relaxed); }
+
+    CodeGeneratorBIP::Options                opt_;
+    std::function<void(const std::string&)>  logger_;
+    const std::atomic<bool>*                 cancelar_ = nullptr;
+};
+
+#endif // COMPILADOR_H
@@ -0,0 +1,74 @@
+#include "deadcode.h"
+
+namespace {
+
+// nenhuma escrita da instrução é lida depois
+bool semUso(const BipAccess& a, const BitSet& vivas) {
+    if (a.sideEffect || a.useAll || a.nDef == 0)
+        return false;
+    for (int k = 0; k < a.nDef; ++k)
+        if (vivas.test(a.def[k]))
+            return false;
+    return true;
+}
+
+} // namespace
+
+DeadCodeStats eliminateDeadCode(std::vector<BipInstr>& code, const BipVars& vars) {
+    DeadCodeStats st;
+    if (!bipCfgComplete(code))
+        return st;
+
+    std::vector<char> remover;
+    for (bool mudou = true; mudou; ) {
+        mudou = false;
+        remover.assign(code.size(), 0);
+        {
+            const BipCfg cfg(code);
+            const auto& blocks = cfg.blocks();
+            const int nb = static_cast<int>(blocks.size());
+
+            std::vector<char> alcancado(nb, 0);
+            std::vector<int>  pilha;
+            if (nb > 0) { alcancado[0] = 1; pilha.push_back(0); }
+            while (!pilha.empty()) {
+                const int b = pilha.back();
+                pilha.pop_back();
+                for (const BipEdge& e : blocks[b].succ)
+                    if (!alcancado[e.to]) { alcancado[e.to] = 1; pilha.push_back(e.to); }
+            }
+
+            const BipLiveness vivas(cfg, vars);
+            BitSet v(vars.count());
+            for (int b = 0; b < nb; ++b) {
+                const BipBlock& blk = blocks[b];
+                if (!alcancado[b]) {
+                    std::fill(remover.begin() + blk.begin, remover.begin() + blk.end, 1);
+                    st.unreachable += blk.end - blk.begin;
+                    mudou = true;
+                    continue;
+                }
+                v = vivas.liveOut(b);
+                for (int i = blk.end - 1; i >= blk.begin; --i) {
+                    const BipAccess a = bipAccess(code[i], vars);
+                    if (semUso(a, v)) {
+                        remover[i] = 1;
+                        const bool store = code[i].op == BipOp::STO || code[i].op == BipOp::STOV;
+                        ++(store ? st.deadStores : st.deadOps);
+                        mudou = true;
+                        continue;
+                    }
+                    bipLiveStep(a, vars, v);
+                }
+            }
+        }
+
+        if (mudou) {
+            std::size_t w = 0;
+            for (std::size_t r = 0; r < code.size(); ++r)
+                if (!remover[r]) code[w++] = code[r];
+            code.resize(w);
+        }
+    }
+    return st;
+}
@@ -0,0 +1,27 @@
+#ifndef DEADCODE_H
+#define DEADCODE_H
+
+#include "bipcfg.h"
+#include "bipir.h"
+
+#include <vector>
+
+// =================== Código morto ===================
+// Remove os blocos que o CFG (bipcfg.h) não alcança a partir da entrada e,
+// com a liveness, as instruções cujo resultado ninguém lê: STO/STOV em
+// variável morta, cargas e contas com ACC (e STATUS) mortos. Repete até
+// estabilizar, pois apagar um STO costuma matar a carga que o alimentava.
+//
+// Acessos às portas nunca são removidos. Se houver linha crua ou desvio
+// para rótulo que não está no código, o CFG não é confiável e nada muda.
+struct DeadCodeStats {
+    int unreachable = 0;    // instruções em blocos inalcançáveis
+    int deadStores  = 0;    // STO/STOV em variável morta
+    int deadOps     = 0;    // cargas e ULA sem uso
+
+    int removed() const { return unreachable + deadStores + deadOps; }
+};
+
+DeadCodeStats eliminateDeadCode(std::vector<BipInstr>& code, const BipVars& vars);
+
+#endif // DEADCODE_H
@@ -0,0 +1,24 @@
+#include "interner.h"
+
+Interner::Id Interner::intern(std::string_view s) {
+    auto it = ids_.find(s);
+    if (it != ids_.end()) return it->second;
+
+    textos_.emplace_back(s);
+    std::string_view v = textos_.back();
+    Id id = static_cast<Id>(nomes_.size());
+    nomes_.push_back(v);
+    ids_.emplace(v, id);
+    return id;
+}
+
+Interner::Id Interner::buscar(std::string_view s) const {
+    auto it = ids_.find(s);
+    return it == ids_.end() ? NENHUM : it->second;
+}
+
+void Interner::clear() {
+    ids_.clear();
+    nomes_.clear();
+    textos_.clear();
+}
@@ -0,0 +1,40 @@
+#ifndef INTERNER_H
+#define INTERNER_H
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// =================== Interner ===================
+// Cada identificador distinto de uma compilação recebe um id compacto
+// (0, 1, 2, ...) no léxico. As fases seguintes comparam e indexam por esse
+// inteiro; o texto fica guardado uma única vez aqui.
+class Interner {
+public:
+    using Id = int;
+    static constexpr Id NENHUM = -1;
+
+    Interner() = default;
+    Interner(const Interner&) = delete;
+    Interner& operator=(const Interner&) = delete;
+
+    // devolve o id do texto, criando um novo se ainda não existir
+    Id intern(std::string_view s);
+
+    // só consulta: NENHUM se o texto nunca foi internado
+    Id buscar(std::string_view s) const;
+
+    std::string_view texto(Id id) const { return nomes_[id]; }
+    std::size_t size() const { return nomes_.size(); }
+
+    void clear();
+
+private:
+    std::deque<std::string>                    textos_;   // endereços estáveis
+    std::vector<std::string_view>              nomes_;    // id -> texto
+    std::unordered_map<std::string_view, Id>   ids_;      // texto -> id
+};
+
+#endif // INTERNER_H
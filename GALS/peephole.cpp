@@ -0,0 +1,146 @@
+#include "peephole.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr uint64_t bit(BipOp op) { return uint64_t(1) << static_cast<int>(op); }
+
+constexpr uint64_t kLoads    = bit(BipOp::LD) | bit(BipOp::LDI) | bit(BipOp::LDV);
+constexpr uint64_t kBranches = bit(BipOp::JMP) | bit(BipOp::JZ)
+                             | bit(BipOp::BEQ) | bit(BipOp::BNE)
+                             | bit(BipOp::BGT) | bit(BipOp::BGE)
+                             | bit(BipOp::BLT) | bit(BipOp::BLE);
+
+// Um elemento do padrão: conjunto de opcodes aceitos e a "variável" do
+// operando. Posições com a mesma letra precisam ter operandos idênticos;
+// '*' aceita qualquer operando.
+struct Pattern {
+    uint64_t ops;
+    char     var;
+};
+
+struct Rule {
+    const char* name;
+    int         len;
+    Pattern     pat[4];
+    const char* keep;    // índices (dígitos) das instruções que sobrevivem
+};
+
+// Nenhuma regra mexe em ADD/SUB & cia: além do ACC elas atualizam o STATUS
+// lido pelos desvios condicionais. Loads e stores não tocam o STATUS.
+const Rule kRules[] = {
+    // o ACC já contém a
+    { "sto-ld",        2, { { bit(BipOp::STO), 'a' }, { bit(BipOp::LD), 'a' } },  "0" },
+    // a já contém o ACC
+    { "ld-sto",        2, { { bit(BipOp::LD), 'a' },  { bit(BipOp::STO), 'a' } }, "0" },
+    { "sto-sto",       2, { { bit(BipOp::STO), 'a' }, { bit(BipOp::STO), 'a' } }, "1" },
+    // carga sobrescrita antes de ser usada
+    { "carga-morta",   2, { { kLoads, '*' },          { kLoads, '*' } },          "1" },
+    // o STO no meio não altera o ACC (nem 'a', a não ser com o mesmo valor)
+    { "recarga",       3, { { bit(BipOp::LD) | bit(BipOp::LDI), 'a' },
+                            { bit(BipOp::STO), '*' },
+                            { bit(BipOp::LD) | bit(BipOp::LDI), 'a' } },         "01" },
+    // desvio para o rótulo logo a seguir
+    { "salto-proximo", 2, { { kBranches, 'L' },       { bit(BipOp::Label), 'L' } }, "1" },
+};
+
+constexpr int kRuleCount = sizeof(kRules) / sizeof(kRules[0]);
+
+bool sameOperand(const BipInstr& a, const BipInstr& b) {
+    return a.kind == b.kind && a.arg == b.arg;
+}
+
+bool touchesVolatile(const BipInstr& in, const std::vector<int>& volatileData) {
+    return in.kind == BipOperand::Sym
+        && std::find(volatileData.begin(), volatileData.end(), in.arg) != volatileData.end();
+}
+
+// Tenta casar a regra com o fim de 'out'. Em caso de sucesso reescreve a
+// cauda e devolve true.
+bool applyAtTail(const Rule& r, std::vector<BipInstr>& out,
+                 const std::vector<int>& volatileData) {
+    if (static_cast<int>(out.size()) < r.len)
+        return false;
+    const size_t base = out.size() - r.len;
+
+    for (int i = 0; i < r.len; ++i) {
+        const BipInstr& in = out[base + i];
+        if (!(r.pat[i].ops & bit(in.op)))
+            return false;
+        if (r.pat[i].var == '*')
+            continue;
+        for (int j = 0; j < i; ++j) {
+            if (r.pat[j].var == r.pat[i].var && !sameOperand(out[base + j], in))
+                return false;
+        }
+    }
+
+    bool kept[4] = {};
+    for (const char* k = r.keep; *k; ++k)
+        kept[*k - '0'] = true;
+    for (int i = 0; i < r.len; ++i) {
+        if (!kept[i] && touchesVolatile(out[base + i], volatileData))
+            return false;
+    }
+
+    BipInstr tail[4];
+    int n = 0;
+    for (const char* k = r.keep; *k; ++k)
+        tail[n++] = out[base + (*k - '0')];
+    out.resize(base);
+    out.insert(out.end(), tail, tail + n);
+    return true;
+}
+
+} // namespace
+
+std::string PeepholeStats::summary() const {
+    std::string s = std::to_string(saved()) + " instruções removidas";
+    std::string detalhe;
+    for (const auto& [nome, vezes] : perRule) {
+        if (vezes == 0)
+            continue;
+        if (!detalhe.empty())
+            detalhe += ", ";
+        detalhe += nome;
+        detalhe += ' ';
+        detalhe += std::to_string(vezes);
+    }
+    if (!detalhe.empty())
+        s += " (" + detalhe + ")";
+    return s;
+}
+
+PeepholeStats peepholeOptimize(std::vector<BipInstr>& code,
+                               const std::vector<int>& volatileData) {
+    PeepholeStats st;
+    st.before = static_cast<int>(code.size());
+    for (const Rule& r : kRules)
+        st.perRule.emplace_back(r.name, 0);
+
+    // Uma única passada: cada instrução é empilhada em 'out' e as regras são
+    // reaplicadas na cauda até nenhuma casar, de modo que uma reescrita pode
+    // expor a seguinte (ex.: sto-ld seguido de ld-sto).
+    std::vector<BipInstr> out;
+    out.reserve(code.size());
+    for (const BipInstr& in : code) {
+        out.push_back(in);
+        bool mudou = true;
+        while (mudou) {
+            mudou = false;
+            for (int i = 0; i < kRuleCount; ++i) {
+                if (applyAtTail(kRules[i], out, volatileData)) {
+                    ++st.perRule[i].second;
+                    mudou = true;
+                    break;
+                }
+            }
+        }
+    }
+
+    code.swap(out);
+    st.after = static_cast<int>(code.size());
+    return st;
+}
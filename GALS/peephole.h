@@ -0,0 +1,27 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include "bipir.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// =================== Peephole ===================
+// Janela deslizante sobre a IR já emitida. Cada regra da tabela (peephole.cpp)
+// descreve uma sequência de instruções adjacentes e quais delas sobrevivem.
+struct PeepholeStats {
+    int before = 0;                                  // instruções antes da passada
+    int after  = 0;                                  // instruções depois
+    std::vector<std::pair<const char*, int>> perRule; // regra -> vezes aplicada
+
+    int saved() const { return before - after; }
+    std::string summary() const;                     // "N instruções removidas (regra k, ...)"
+};
+
+// 'volatileData': ids de dados com efeito colateral na leitura/escrita
+// (portas de E/S). Instruções que os acessam nunca são removidas.
+PeepholeStats peepholeOptimize(std::vector<BipInstr>& code,
+                               const std::vector<int>& volatileData);
+
+#endif // PEEPHOLE_H
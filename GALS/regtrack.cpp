@@ -0,0 +1,161 @@
+#include "regtrack.h"
+
+#include <algorithm>
+
+namespace {
+
+// O que se sabe sobre o valor de um registrador
+struct Conteudo {
+    bool             constante = false;
+    long             k = 0;
+    std::vector<int> vars;          // variáveis cuja memória tem este mesmo valor
+    int              vetor = -1;    // == vetor[$indr] ...
+    int              geracao = -1;  // ... com o $indr desta geração
+
+    void limpar() {
+        constante = false;
+        vars.clear();
+        vetor = -1;
+    }
+    bool tem(int v) const { return std::find(vars.begin(), vars.end(), v) != vars.end(); }
+    void tirar(int v) { vars.erase(std::remove(vars.begin(), vars.end(), v), vars.end()); }
+};
+
+bool mesmoValor(const Conteudo& a, const Conteudo& b) {
+    if (a.constante && b.constante && a.k == b.k)
+        return true;
+    for (int v : a.vars)
+        if (b.tem(v))
+            return true;
+    return false;
+}
+
+} // namespace
+
+int trackRegisters(std::vector<BipInstr>& code, int indr,
+                   const std::vector<int>& volatileData) {
+    auto volatil = [&](const BipInstr& in) {
+        return in.kind == BipOperand::Sym
+            && std::find(volatileData.begin(), volatileData.end(), in.arg) != volatileData.end();
+    };
+
+    Conteudo acc, ind;
+    int geracaoIndr = 0;            // muda a cada escrita no $indr
+    int removidas = 0;
+
+    auto esquecerTudo = [&]() {
+        acc.limpar();
+        ind.limpar();
+        ++geracaoIndr;
+    };
+
+    std::size_t w = 0;
+    for (std::size_t r = 0; r < code.size(); ++r) {
+        const BipInstr in = code[r];
+        const int dado = in.kind == BipOperand::Sym ? static_cast<int>(in.arg) : -1;
+        bool redundante = false;
+
+        switch (in.op) {
+        case BipOp::LD:
+            if (volatil(in)) {
+                acc.limpar();
+            } else if (dado == indr) {
+                if (mesmoValor(acc, ind)) {
+                    redundante = true;
+                } else {
+                    acc = ind;
+                    acc.vetor = -1;
+                }
+            } else if (acc.tem(dado)) {
+                redundante = true;
+            } else {
+                acc.limpar();
+                acc.vars.push_back(dado);
+            }
+            break;
+
+        case BipOp::LDI:
+            if (in.kind == BipOperand::Imm && acc.constante && acc.k == in.arg) {
+                redundante = true;
+            } else {
+                acc.limpar();
+                if (in.kind == BipOperand::Imm) {
+                    acc.constante = true;
+                    acc.k = in.arg;
+                }
+            }
+            break;
+
+        case BipOp::LDV:
+            if (acc.vetor == dado && acc.geracao == geracaoIndr) {
+                redundante = true;
+            } else {
+                acc.limpar();
+                acc.vetor   = dado;
+                acc.geracao = geracaoIndr;
+            }
+            break;
+
+        case BipOp::STO:
+            if (volatil(in)) {
+                break;                          // saída: ACC e memória intactos
+            } else if (dado == indr) {
+                if (mesmoValor(acc, ind)) {
+                    redundante = true;
+                } else {
+                    ind = acc;
+                    ind.vetor = -1;
+                    ++geracaoIndr;
+                }
+            } else if (acc.tem(dado)) {
+                redundante = true;              // a memória já tem este valor
+            } else {
+                const bool indrIgual = mesmoValor(acc, ind);
+                ind.tirar(dado);
+                if (acc.vetor == dado)          // 'dado' é o próprio vetor (v[0])
+                    acc.vetor = -1;
+                acc.vars.push_back(dado);
+                if (indrIgual)
+                    ind.vars.push_back(dado);
+            }
+            break;
+
+        case BipOp::STOV:
+            if (acc.vetor == dado && acc.geracao == geracaoIndr) {
+                redundante = true;
+            } else {
+                // v[$indr] muda: v usado como escalar (v[0]) deixa de valer
+                acc.tirar(dado);
+                ind.tirar(dado);
+                acc.vetor   = dado;
+                acc.geracao = geracaoIndr;
+            }
+            break;
+
+        // desvios condicionais: no caminho que segue nada muda
+        case BipOp::JZ:  case BipOp::BEQ: case BipOp::BNE:
+        case BipOp::BGT: case BipOp::BGE: case BipOp::BLT: case BipOp::BLE:
+            break;
+
+        // fim de bloco básico (ou efeito desconhecido)
+        case BipOp::Label: case BipOp::JMP:
+        case BipOp::CALL:  case BipOp::RETURN: case BipOp::HLT:
+        case BipOp::Raw:
+            esquecerTudo();
+            break;
+
+        // aritmética/lógica: ACC passa a ser desconhecido
+        default:
+            acc.limpar();
+            break;
+        }
+
+        if (redundante)
+            ++removidas;
+        else
+            code[w++] = in;
+    }
+
+    code.resize(w);
+    return removidas;
+}
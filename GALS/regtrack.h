@@ -0,0 +1,20 @@
+#ifndef REGTRACK_H
+#define REGTRACK_H
+
+#include "bipir.h"
+
+#include <vector>
+
+// =================== Rastreamento de ACC / $indr ===================
+// Passada para frente, dentro de cada bloco básico, que acompanha o que o
+// ACC e o $indr contêm (constante, variáveis com o mesmo valor, elemento
+// v[$indr]) e remove LD/LDI/LDV/STO redundantes. O conhecimento é zerado
+// em rótulos, CALL, RETURN e linhas cruas.
+//
+// 'indr': id de dado do $indr; 'volatileData': portas de E/S (nunca
+// removidas nem consideradas iguais a nada). Devolve quantas instruções
+// foram removidas.
+int trackRegisters(std::vector<BipInstr>& code, int indr,
+                   const std::vector<int>& volatileData);
+
+#endif // REGTRACK_H
@@ -0,0 +1,54 @@
+#include "temppool.h"
+
+#include <algorithm>
+
+int colorTemps(const std::vector<BipInstr>& code, const BipVars& vars,
+               const std::vector<int>& temps, std::vector<int>& cor) {
+    if (!bipCfgComplete(code))
+        return -1;
+
+    const int nt = static_cast<int>(temps.size());
+    std::vector<int> no(vars.count(), -1);          // id de dado -> índice em temps
+    for (int i = 0; i < nt; ++i)
+        no[temps[i]] = i;
+
+    // interferência: cada escrita de um temporário contra os vivos depois dela
+    const BipCfg      cfg(code);
+    const BipLiveness vivas(cfg, vars);
+    std::vector<std::vector<int>> viz(nt);
+    BitSet v(vars.count());
+    for (std::size_t b = 0; b < cfg.blocks().size(); ++b) {
+        const BipBlock& blk = cfg.blocks()[b];
+        v = vivas.liveOut(static_cast<int>(b));
+        for (int i = blk.end - 1; i >= blk.begin; --i) {
+            const BipAccess a = bipAccess(code[i], vars);
+            for (int k = 0; k < a.nDef; ++k) {
+                const int x = a.def[k] < vars.data ? no[a.def[k]] : -1;
+                if (x < 0) continue;
+                for (int y = 0; y < nt; ++y) {
+                    if (y != x && v.test(temps[y])) {
+                        viz[x].push_back(y);
+                        viz[y].push_back(x);
+                    }
+                }
+            }
+            bipLiveStep(a, vars, v);
+        }
+    }
+
+    int slots = 0;
+    for (int c : cor)
+        slots = std::max(slots, c + 1);
+    std::vector<char> ocupado;
+    for (int x = 0; x < nt; ++x) {
+        if (cor[x] >= 0) continue;
+        ocupado.assign(slots + 1, 0);
+        for (int y : viz[x])
+            if (cor[y] >= 0) ocupado[cor[y]] = 1;
+        int c = 0;
+        while (ocupado[c]) ++c;
+        cor[x] = c;
+        slots = std::max(slots, c + 1);
+    }
+    return slots;
+}
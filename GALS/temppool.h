@@ -0,0 +1,24 @@
+#ifndef TEMPPOOL_H
+#define TEMPPOOL_H
+
+#include "bipcfg.h"
+#include "bipir.h"
+
+#include <vector>
+
+// =================== Pool de temporários ===================
+// O gerador dá a cada função os seus próprios __TMPk (virtuais). Com a
+// liveness do CFG interprocedural, temporários que nunca estão vivos ao
+// mesmo tempo passam a dividir o mesmo __TMPn: um temporário vivo através
+// de um CALL interfere com todos os que a função chamada (e as que ela
+// chama) usam, então a chamada não o destrói.
+//
+// 'temps': ids de dado dos temporários. 'cor' (mesmo tamanho): na entrada,
+// >= 0 fixa o slot daquele temporário e -1 pede um; na saída, todos têm
+// slot, o menor livre entre os vizinhos (coloração gulosa, na ordem de
+// 'temps'). Devolve quantos slots foram usados, ou -1 (sem mexer em 'cor')
+// se o CFG não estiver completo.
+int colorTemps(const std::vector<BipInstr>& code, const BipVars& vars,
+               const std::vector<int>& temps, std::vector<int>& cor);
+
+#endif // TEMPPOOL_H
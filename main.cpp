@@ -42,7 +42,7 @@ int main() {
 
         for (size_t i = 0; i < sem.tabelaSimbolo.size(); ++i) {
             const Simbolo& s = sem.tabelaSimbolo.at(i);
-            cout << s;
+            cout << descreverSimbolo(sem.tabelaSimbolo, s) << endl;
         }
     }
     catch (LexicalError& err) {
@@ -11,6 +11,12 @@
 #include "LexicalError.h"
 #include "SyntacticError.h"
 #include "SemanticError.h"
+#include "compilador.h"
+
+#include <atomic>
+#include <memory>
+
+class QPlainTextEdit;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -34,6 +40,14 @@ private:
     // Helper para preencher o QTableView com os símbolos do semântico
     void preencherTabelaSimbolos(const std::vector<Simbolo>& tabela);
 
+    // Compilação em segundo plano: um pedido novo cancela o anterior e só
+    // o resultado do pedido mais recente (geracao_) chega à interface
+    std::shared_ptr<std::atomic<bool>> cancelarAtual_;
+    quint64 geracao_ = 0;
+
+    void exibirResultado(const ResultadoCompilacao& r, bool asmSalvo);
+    QPlainTextEdit* widgetAsm() const;
+
     // Converte mensagens/strings para QString
     static QString toQString(const QString &s) { return s; }
     static QString toQString(const std::string &s) { return QString::fromStdString(s); }
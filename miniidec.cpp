@@ -0,0 +1,462 @@
+// miniidec: compilador de linha de comando (sem Qt).
+//
+//   miniidec [-j N] [-o pasta] [-v] [-O0] [--unroll N] [--cfg] [--run] [--bench N]
+//            [--profile] [--batch] arquivo1.c [arquivo2.c ...]
+//
+// Cada arquivo vira um .asm (mesmo nome, extensão trocada). Os arquivos são
+// compilados em paralelo, um por tarefa, num pool de N threads. No fim mostra
+// o tempo e a vazão de cada arquivo e do lote inteiro. -O0 desliga as passadas
+// de otimização; com -v o número de instruções economizadas aparece por arquivo.
+// --cfg grava também o grafo de fluxo (Graphviz) de cada arquivo em .dot.
+// --run executa cada programa na máquina virtual (bipvm.h), com a entrada
+// lida de arquivo.in (inteiros separados por espaço), se existir. --bench N
+// executa N vezes com cada despacho da máquina (switch, threaded e jit),
+// confere que todos dão o mesmo resultado e mostra os milhões de instruções
+// da BIP por segundo de cada um (use -j 1 para medir sem as outras threads
+// disputando a máquina). --profile executa com perfil (bipperfil.h) e grava
+// ao lado do .asm o .prof (assembly anotado com execuções, ciclos e as
+// linhas do fonte; totais por rótulo e por linha) e o .folded (ciclos por
+// cadeia de CALL, para flamegraph.pl ou speedscope).
+// --batch executa, depois de compilar tudo, cada programa com cada vetor de
+// entrada de arquivo.lote (um vetor por linha) nas N threads (biplote.h) e
+// grava o resultado de cada vetor, na ordem, em arquivo.saidas.
+
+#include "biplote.h"
+#include "bipperfil.h"
+#include "bipvm.h"
+#include "compilador.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Relogio = std::chrono::steady_clock;
+
+struct Tarefa {
+    std::string entrada;
+    std::string saida;
+    std::string saidaCfg;     // .dot (só com --cfg)
+    std::string saidaPerfil;  // .prof e .folded (só com --profile)
+    std::string saidaPilhas;
+    std::string saidaLote;    // .saidas (só com --batch)
+
+    // preenchidos pela thread que compilou o arquivo
+    bool        ok = false;
+    std::string status;
+    std::size_t bytes = 0;
+    double      segundos = 0.0;
+    std::vector<std::string> mensagens;
+    std::string peephole;     // resumo das otimizações (vazio se desligadas)
+    std::string execucao;     // resultado na máquina virtual (só com --run)
+    std::string desempenho;   // MIPS de cada despacho (só com --bench)
+    std::string assembly;     // guardado para o lote (só com --batch)
+    std::string lote;         // resumo do lote (só com --batch)
+};
+
+std::string trocarExtensao(const std::string& caminho, const std::string& pasta,
+                           const char* ext = ".asm")
+{
+    std::string base = caminho;
+    const std::size_t barra = base.find_last_of("/\\");
+    const std::size_t ponto = base.find_last_of('.');
+    if (ponto != std::string::npos && (barra == std::string::npos || ponto > barra))
+        base.erase(ponto);
+
+    if (!pasta.empty()) {
+        const std::string nome = barra == std::string::npos ? base : base.substr(barra + 1);
+        return pasta + "/" + nome + ext;
+    }
+    return base + ext;
+}
+
+bool lerArquivo(const std::string& caminho, std::string& out)
+{
+    std::ifstream f(caminho, std::ios::binary);
+    if (!f)
+        return false;
+    std::ostringstream ss;
+    ss << f.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+const char* nomeEtapa(ResultadoCompilacao::Etapa e)
+{
+    switch (e) {
+    case ResultadoCompilacao::Etapa::Sucesso:       return "ok";
+    case ResultadoCompilacao::Etapa::ErroLexico:    return "Erro Léxico";
+    case ResultadoCompilacao::Etapa::ErroSintatico: return "Erro Sintático";
+    case ResultadoCompilacao::Etapa::ErroSemantico: return "Erro Semântico";
+    case ResultadoCompilacao::Etapa::ErrosMarcados: return "Erros semânticos";
+    case ResultadoCompilacao::Etapa::Cancelada:     return "Cancelada";
+    }
+    return "?";
+}
+
+// no limite de instruções o threaded pode parar um pouco antes do switch
+bool mesmoResultado(const ResultadoExecucao& a, const ResultadoExecucao& b)
+{
+    if (a.fim != b.fim || a.saida != b.saida)
+        return false;
+    return a.fim == ResultadoExecucao::Fim::Limite
+        || (a.instrucoes == b.instrucoes && a.ciclos == b.ciclos && a.acc == b.acc && a.pc == b.pc);
+}
+
+// inteiros separados por espaço
+std::vector<int> lerInteiros(const std::string& texto)
+{
+    std::vector<int> v;
+    std::istringstream ss(texto);
+    int x;
+    while (ss >> x)
+        v.push_back(x);
+    return v;
+}
+
+std::string textoExecucao(const ResultadoExecucao& r)
+{
+    std::ostringstream out;
+    out << bipFimTexto(r.fim) << ", " << r.instrucoes << " instruções, "
+        << r.ciclos << " ciclos; saída:";
+    for (int v : r.saida)
+        out << ' ' << v;
+    return out.str();
+}
+
+// milhões de instruções da BIP por segundo em 'vezes' execuções
+double medirMips(const BipImage& img, BipVm::Despacho d, const std::vector<int>& entrada, int vezes)
+{
+    const BipVm vm(img, d);
+    uint64_t instrucoes = 0;
+    const Relogio::time_point inicio = Relogio::now();
+    for (int k = 0; k < vezes; ++k)
+        instrucoes += vm.run(entrada).instrucoes;
+    const double s = std::chrono::duration<double>(Relogio::now() - inicio).count();
+    return s > 0.0 ? (double) instrucoes / s / 1e6 : 0.0;
+}
+
+void executarTarefa(const ResultadoCompilacao& rc, const std::string& fonte, Tarefa& t,
+                    int repeticoes)
+{
+    const std::string& assembly = rc.assembly;
+    std::vector<int> entrada;
+    std::string texto;
+    if (lerArquivo(trocarExtensao(t.entrada, "", ".in"), texto))
+        entrada = lerInteiros(texto);
+
+    BipImage img;
+    std::string erro;
+    if (!bipAssemble(assembly, img, erro)) {
+        t.ok = false;
+        t.execucao = "montagem: " + erro;
+        return;
+    }
+    BipPerfil perfil;
+    const bool perfilar = !t.saidaPerfil.empty();
+    const ResultadoExecucao r = perfilar ? BipVm(img).run(entrada, BipVm::Limites(), perfil)
+                                         : BipVm(img).run(entrada);
+    if (!r.ok())
+        t.ok = false;
+    if (perfilar) {
+        std::ofstream prof(t.saidaPerfil, std::ios::binary | std::ios::trunc);
+        std::ofstream pilhas(t.saidaPilhas, std::ios::binary | std::ios::trunc);
+        if (prof && pilhas) {
+            prof << bipListagemPerfil(img, perfil, assembly, rc.linhaFonte, fonte);
+            pilhas << bipPilhasDobradas(img, perfil);
+            t.status += ", " + t.saidaPerfil + ", " + t.saidaPilhas;
+        } else {
+            t.ok = false;
+            t.status += " (não foi possível gravar o perfil)";
+        }
+    }
+
+    if (repeticoes > 0) {
+        // teste diferencial: os outros despachos têm de dar o resultado do switch
+        const ResultadoExecucao ref = BipVm(img, BipVm::Despacho::Switch).run(entrada);
+        const char* diverge = nullptr;
+        if (!mesmoResultado(ref, BipVm(img, BipVm::Despacho::Threaded).run(entrada)))
+            diverge = "threaded";
+        else if (!mesmoResultado(ref, BipVm(img, BipVm::Despacho::Jit).run(entrada)))
+            diverge = "jit";
+
+        const double sw = medirMips(img, BipVm::Despacho::Switch, entrada, repeticoes);
+        const double th = medirMips(img, BipVm::Despacho::Threaded, entrada, repeticoes);
+        const double jt = medirMips(img, BipVm::Despacho::Jit, entrada, repeticoes);
+        char buf[192];
+        std::snprintf(buf, sizeof buf,
+                      "desempenho: switch %.1f MIPS, threaded %.1f MIPS (%.2fx)%s, jit %.1f MIPS (%.2fx)%s",
+                      sw, th, sw > 0.0 ? th / sw : 0.0,
+                      BipVm::threadedDisponivel() ? "" : " [sem computed goto]",
+                      jt, sw > 0.0 ? jt / sw : 0.0,
+                      BipVm::jitDisponivel() ? "" : " [sem JIT]");
+        t.desempenho = buf;
+        if (diverge) {
+            t.ok = false;
+            t.status += std::string(" (o ") + diverge + " diverge do switch)";
+        }
+    }
+    t.execucao = "execução: " + textoExecucao(r);
+}
+
+// arquivo.lote -> arquivo.saidas, com os vetores espalhados por 'threads'
+void executarLote(Tarefa& t, unsigned threads)
+{
+    std::string texto;
+    if (!lerArquivo(trocarExtensao(t.entrada, "", ".lote"), texto)) {
+        t.ok = false;
+        t.lote = "lote: não foi possível ler " + trocarExtensao(t.entrada, "", ".lote");
+        return;
+    }
+    std::vector<std::vector<int>> entradas;
+    std::istringstream linhas(texto);
+    std::string linha;
+    while (std::getline(linhas, linha))     // linha vazia = vetor vazio
+        entradas.push_back(lerInteiros(linha));
+
+    BipImage img;
+    std::string erro;
+    if (!bipAssemble(t.assembly, img, erro)) {
+        t.ok = false;
+        t.lote = "montagem: " + erro;
+        return;
+    }
+    const BipVm vm(img);
+    const ResultadoLote lote = bipExecutaLote(vm, entradas, BipVm::Limites(), threads);
+
+    std::ofstream out(t.saidaLote, std::ios::binary | std::ios::trunc);
+    for (const ResultadoExecucao& r : lote.resultados)
+        out << textoExecucao(r) << '\n';
+    if (!out)
+        t.ok = false;
+    if (lote.erros() > 0)
+        t.ok = false;
+
+    char buf[192];
+    std::snprintf(buf, sizeof buf,
+                  "lote: %zu vetor(es), %d com erro, %u thread(s), %llu roubo(s): %.3f ms, %.1f Mciclos/s -> ",
+                  entradas.size(), lote.erros(), lote.threads, (unsigned long long) lote.roubos,
+                  lote.segundos * 1000.0, lote.ciclosPorSegundo() / 1e6);
+    t.lote = buf + (out ? t.saidaLote : "não foi possível gravar " + t.saidaLote);
+}
+
+void compilarTarefa(const Compilador& compilador, Tarefa& t, bool executar, int repeticoes)
+{
+    const Relogio::time_point inicio = Relogio::now();
+
+    std::string fonte;
+    if (!lerArquivo(t.entrada, fonte)) {
+        t.status = "não foi possível ler o arquivo";
+        return;
+    }
+    t.bytes = fonte.size();
+
+    const ResultadoCompilacao r = compilador.compilar(fonte);
+    t.mensagens = r.mensagens;
+    if (r.ok() && r.peephole.before > 0)
+        t.peephole = "otimização: " + r.peephole.summary();
+
+    if (!r.ok()) {
+        t.status = nomeEtapa(r.etapa);
+        if (!r.erro.empty())
+            t.status += ": " + r.erro + " - posição: " + std::to_string(r.posicao);
+    } else {
+        std::ofstream out(t.saida, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            t.status = "não foi possível gravar " + t.saida;
+        } else {
+            out << r.assembly;
+            t.ok = true;
+            t.status = "ok -> " + t.saida;
+        }
+        if (t.ok && !t.saidaCfg.empty()) {
+            std::ofstream dot(t.saidaCfg, std::ios::binary | std::ios::trunc);
+            if (dot) {
+                dot << r.cfgDot;
+                t.status += ", " + t.saidaCfg;
+            }
+        }
+    }
+
+    t.segundos = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    if (executar && t.ok)
+        executarTarefa(r, fonte, t, repeticoes);
+    if (!t.saidaLote.empty() && r.ok())
+        t.assembly = r.assembly;
+}
+
+void uso()
+{
+    std::cerr << "uso: miniidec [-j N] [-o pasta] [-v] [-O0] [--unroll N] [--cfg] [--run] [--bench N]\n"
+                 "               [--profile] [--batch] arquivo.c [arquivo.c ...]\n"
+                 "  -j N        número de threads (padrão: núcleos da máquina)\n"
+                 "  -o pasta    grava os .asm nesta pasta\n"
+                 "  -v          mostra os avisos do semântico e o ganho das otimizações\n"
+                 "  -O0         não otimiza o assembly\n"
+                 "  --unroll N  orçamento (instruções) para desenrolar laços for; 0 desliga\n"
+                 "  --cfg       grava o grafo de fluxo em .dot (Graphviz) ao lado do .asm\n"
+                 "  --run       executa na máquina virtual da BIP (entrada em arquivo.in)\n"
+                 "  --bench N   como --run; compara os despachos e mede N execuções de cada (use -j 1)\n"
+                 "  --profile   como --run; grava o perfil em .prof e .folded ao lado do .asm\n"
+                 "  --batch     executa com cada linha de arquivo.lote como entrada; saídas em .saidas\n";
+}
+
+double mbPorSegundo(std::size_t bytes, double s)
+{
+    return s > 0.0 ? (double) bytes / (1024.0 * 1024.0) / s : 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned    threads = std::max(1u, std::thread::hardware_concurrency());
+    std::string pasta;
+    bool        verboso = false;
+    bool        otimizar = true;
+    bool        cfg = false;
+    bool        executar = false;
+    bool        perfilar = false;
+    bool        lote = false;
+    int         repeticoes = 0;
+    int         desenrolar = CodeGeneratorBIP::Options().unrollBudget;
+    std::vector<Tarefa> tarefas;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg == "-j" && i + 1 < argc) {
+            threads = (unsigned) std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "-o" && i + 1 < argc) {
+            pasta = argv[++i];
+        } else if (arg == "-v") {
+            verboso = true;
+        } else if (arg == "-O0") {
+            otimizar = false;
+        } else if (arg == "--unroll" && i + 1 < argc) {
+            desenrolar = std::max(0, std::atoi(argv[++i]));
+        } else if (arg == "--cfg") {
+            cfg = true;
+        } else if (arg == "--run") {
+            executar = true;
+        } else if (arg == "--bench" && i + 1 < argc) {
+            repeticoes = std::max(1, std::atoi(argv[++i]));
+            executar = true;
+        } else if (arg == "--profile") {
+            perfilar = true;
+            executar = true;
+        } else if (arg == "--batch") {
+            lote = true;
+        } else if (arg == "-h" || arg == "--help") {
+            uso();
+            return 0;
+        } else if (!arg.empty() && arg[0] == '-') {
+            uso();
+            return 2;
+        } else {
+            Tarefa t;
+            t.entrada = arg;
+            tarefas.push_back(std::move(t));
+        }
+    }
+
+    if (tarefas.empty()) {
+        uso();
+        return 2;
+    }
+    // -o pode vir depois dos arquivos
+    for (Tarefa& t : tarefas) {
+        t.saida = trocarExtensao(t.entrada, pasta);
+        if (cfg)
+            t.saidaCfg = trocarExtensao(t.entrada, pasta, ".dot");
+        if (perfilar) {
+            t.saidaPerfil = trocarExtensao(t.entrada, pasta, ".prof");
+            t.saidaPilhas = trocarExtensao(t.entrada, pasta, ".folded");
+        }
+        if (lote)
+            t.saidaLote = trocarExtensao(t.entrada, pasta, ".saidas");
+    }
+
+    const unsigned threadsLote = threads;   // o lote divide vetores, não arquivos
+    threads = std::min<unsigned>(threads, (unsigned) tarefas.size());
+
+    // Compilador é imutável durante o lote: uma instância serve a todas as threads
+    CodeGeneratorBIP::Options opt;
+    opt.peephole         = otimizar;
+    opt.registerTracking = otimizar;
+    opt.constantFolding  = otimizar;
+    opt.deadCode         = otimizar;
+    opt.sethiUllman      = otimizar;
+    opt.jumpingCode      = otimizar;
+    opt.loopRotation     = otimizar;
+    opt.loopInvariants   = otimizar;
+    opt.unrollBudget     = otimizar ? desenrolar : 0;
+    opt.dumpCfg          = cfg;
+    const Compilador compilador(opt);
+
+    // pool simples: cada thread pega o próximo arquivo livre
+    std::atomic<std::size_t> proximo(0);
+    auto trabalhador = [&]() {
+        for (;;) {
+            const std::size_t i = proximo.fetch_add(1, std::memory_order_relaxed);
+            if (i >= tarefas.size())
+                return;
+            compilarTarefa(compilador, tarefas[i], executar, repeticoes);
+        }
+    };
+
+    const Relogio::time_point inicio = Relogio::now();
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned k = 0; k < threads; ++k)
+        pool.emplace_back(trabalhador);
+    for (std::thread& th : pool)
+        th.join();
+
+    const double total = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    // os lotes vêm depois da compilação, um programa por vez, cada um com todas as threads
+    for (Tarefa& t : tarefas)
+        if (!t.assembly.empty())
+            executarLote(t, threadsLote);
+
+    // relatório, na ordem dos arquivos na linha de comando
+    std::size_t bytes = 0;
+    int falhas = 0;
+    for (const Tarefa& t : tarefas) {
+        std::printf("%-40s %9zu B %9.3f ms %8.2f MB/s  %s\n",
+                    t.entrada.c_str(), t.bytes, t.segundos * 1000.0,
+                    mbPorSegundo(t.bytes, t.segundos), t.status.c_str());
+        if (!t.execucao.empty())
+            std::printf("    %s\n", t.execucao.c_str());
+        if (!t.desempenho.empty())
+            std::printf("    %s\n", t.desempenho.c_str());
+        if (!t.lote.empty())
+            std::printf("    %s\n", t.lote.c_str());
+        if (verboso) {
+            for (const std::string& m : t.mensagens)
+                std::printf("    %s\n", m.c_str());
+            if (!t.peephole.empty())
+                std::printf("    %s\n", t.peephole.c_str());
+        }
+        bytes += t.bytes;
+        if (!t.ok)
+            ++falhas;
+    }
+
+    std::printf("\n%zu arquivo(s), %d com erro, %u thread(s): %.3f ms, %.2f MB/s, %.1f arquivos/s\n",
+                tarefas.size(), falhas, threads, total * 1000.0,
+                mbPorSegundo(bytes, total), total > 0.0 ? tarefas.size() / total : 0.0);
+
+    return falhas == 0 ? 0 : 1;
+}